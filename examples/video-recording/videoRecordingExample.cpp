@@ -44,8 +44,9 @@ int main(int argc, char** argv) {
   std::string recordPath = "record";
   std::cout << std::endl;
 
-  // Set record flags
-  ale.setString("record_screen_dir", recordPath.c_str());
+  // Set record flags. Frames are streamed to a single file; they can be
+  // turned into a video with ale-convert-recording.
+  ale.setString("record_screen_file", (recordPath + "/frames.alev").c_str());
   ale.setString("record_sound_filename", (recordPath + "/sound.wav").c_str());
   // We set fragsize to 64 to ensure proper sound sync
   ale.setInt("fragsize", 64);
@@ -70,9 +71,10 @@ int main(int argc, char** argv) {
   }
 
   std::cout << std::endl;
-  std::cout << "Recording complete. To create a video, you may want to run \n"
-               "  examples/video-recording/*-join-video.sh. See docs for "
-               "details.."
+  std::cout << "Recording complete. To create a video, run \n"
+               "  ale-convert-recording --sound record/sound.wav "
+               "record/frames.alev agent.mp4\n"
+               "See docs for details."
             << std::endl;
 
   return 0;
@@ -32,12 +32,14 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cctype>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <iterator>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -46,9 +48,15 @@
 
 #include "common/ColourPalette.hpp"
 #include "common/Constants.h"
+#include "common/MappedFile.hpp"
+#include "common/ThreadPool.hpp"
+#include "common/Trace.hpp"
 #include "emucore/Console.hxx"
 #include "emucore/Props.hxx"
 #include "emucore/MD5.hxx"
+#include "emucore/PropsSet.hxx"
+#include "emucore/System.hxx"
+#include "emucore/TIA.hxx"
 #include "environment/ale_screen.hpp"
 #include "games/RomSettings.hpp"
 
@@ -97,12 +105,16 @@ void ALEInterface::loadSettings(const fs::path& romfile,
 }
 
 ALEInterface::ALEInterface() {
-  Logger::Info << welcomeMessage() << std::endl;
+  if (Logger::enabled(Logger::Info)) {
+    Logger::Info << welcomeMessage() << std::endl;
+  }
   createOSystem(theOSystem, theSettings);
 }
 
 ALEInterface::ALEInterface(bool display_screen) {
-  Logger::Info << welcomeMessage() << std::endl;
+  if (Logger::enabled(Logger::Info)) {
+    Logger::Info << welcomeMessage() << std::endl;
+  }
   createOSystem(theOSystem, theSettings);
   this->setBool("display_screen", display_screen);
 }
@@ -113,6 +125,7 @@ ALEInterface::~ALEInterface() {}
 // ready to play. Resets the OSystem/Console/Environment/etc. This is
 // necessary after changing a setting.
 void ALEInterface::loadROM(fs::path rom_file) {
+  TraceScope trace("loadROM");
   assert(theOSystem.get());
   if (rom_file.empty()) {
     rom_file = theOSystem->romFile();
@@ -161,31 +174,67 @@ void ALEInterface::loadROM(fs::path rom_file) {
   romSettings->modifyEnvironmentSettings(theOSystem->settings());
 
   environment.reset(new StellaEnvironment(theOSystem.get(), romSettings.get()));
-  max_num_frames = theOSystem->settings().getInt("max_num_frames_per_episode");
+  max_num_frames =
+      theOSystem->settings().getInt(Setting_MaxNumFramesPerEpisode);
+  trajectory.reset();
   environment->reset();
 }
 
+// Returns the ROM id for an opened file, or nullopt if unsupported
+static std::optional<std::string> supportedROM(const MappedFile& rom) {
+  std::string md5 = MD5(rom.data(), rom.size());
+  const char* name = supportedRomName(md5);
+
+  if (name != NULL) {
+    return std::string(name);
+  }
+  return std::nullopt;
+}
+
 std::optional<std::string> ALEInterface::isSupportedROM(const fs::path& rom_file){
   if (!fs::exists(rom_file)) {
     throw std::runtime_error("ROM file doesn't exist");
   }
 
-  std::ifstream fsnode(rom_file, std::ios::binary);
-  if (!fsnode.good()) {
+  MappedFile rom(rom_file);
+  if (!rom.good()) {
     throw std::runtime_error("Failed to open rom file.");
   }
 
-  std::vector<uint8_t> rom((std::istreambuf_iterator<char>(fsnode)),
-                            std::istreambuf_iterator<char>());
-  fsnode.close();
+  return supportedROM(rom);
+}
+
+std::map<fs::path, std::optional<std::string>>
+ALEInterface::scanROMs(const std::vector<fs::path>& rom_files, size_t threads) {
+  std::vector<std::optional<std::string>> ids(rom_files.size());
 
-  std::string md5 = MD5(rom.data(), rom.size());
-  RomSettings* wrapper = buildRomRLWrapper(rom_file, md5);
+  ThreadPool::run(rom_files.size(), threads, [&](size_t, size_t i) {
+    MappedFile rom(rom_files[i]);
+    if (rom.good()) {
+      ids[i] = supportedROM(rom);
+    }
+  });
 
-  if (wrapper != NULL && wrapper->md5() == md5) {
-    return wrapper->rom();
+  std::map<fs::path, std::optional<std::string>> result;
+  for (size_t i = 0; i < rom_files.size(); i++) {
+    result.emplace(rom_files[i], std::move(ids[i]));
   }
-  return std::nullopt;
+  return result;
+}
+
+std::map<fs::path, std::optional<std::string>>
+ALEInterface::scanROMDirectory(const fs::path& directory, size_t threads) {
+  if (!fs::is_directory(directory)) {
+    throw std::runtime_error("ROM directory doesn't exist");
+  }
+
+  std::vector<fs::path> rom_files;
+  for (const fs::directory_entry& entry : fs::directory_iterator(directory)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+      rom_files.push_back(entry.path());
+    }
+  }
+  return scanROMs(rom_files, threads);
 }
 
 // Get the value of a setting.
@@ -209,34 +258,46 @@ float ALEInterface::getFloat(const std::string& key) {
   return theSettings->getFloat(key);
 }
 
-// Set the value of a setting.
+// Set the value of a setting. Settings are validated in one batch when the
+// next ROM is loaded.
 void ALEInterface::setString(const std::string& key, const std::string& value) {
   assert(theSettings.get());
   assert(theOSystem.get());
   theSettings->setString(key, value);
-  theSettings->validate();
 }
 void ALEInterface::setInt(const std::string& key, const int value) {
   assert(theSettings.get());
   assert(theOSystem.get());
   theSettings->setInt(key, value);
-  theSettings->validate();
 }
 void ALEInterface::setBool(const std::string& key, const bool value) {
   assert(theSettings.get());
   assert(theOSystem.get());
   theSettings->setBool(key, value);
-  theSettings->validate();
 }
 void ALEInterface::setFloat(const std::string& key, const float value) {
   assert(theSettings.get());
   assert(theOSystem.get());
   theSettings->setFloat(key, value);
-  theSettings->validate();
 }
 
 // Resets the game, but not the full system.
-void ALEInterface::reset_game() { environment->reset(); }
+void ALEInterface::reset_game() {
+  if (trajectory) {
+    trajectory->steps.push_back(Trajectory::RESET_STEP);
+  }
+  environment->reset();
+}
+
+void ALEInterface::setStartStates(const std::vector<ALEState>& states) {
+  if (!environment) {
+    throw std::runtime_error("ROM not set");
+  }
+  if (trajectory && !states.empty()) {
+    throw std::runtime_error("Start states can't be logged in a trajectory");
+  }
+  environment->setStartStates(states);
+}
 
 // Indicates if the game has ended.
 bool ALEInterface::game_over() const { return environment->isTerminal(); }
@@ -255,9 +316,86 @@ int ALEInterface::lives() {
 // when necessary - this method will keep pressing buttons on the
 // game over screen.
 reward_t ALEInterface::act(Action action) {
+  if (trajectory) {
+    trajectory->steps.push_back(action);
+  }
   return environment->act(action, PLAYER_B_NOOP);
 }
 
+// Player B's actions are offset from player A's
+static Action playerBAction(Action action) {
+  return action < PLAYER_B_NOOP ? (Action)(action + PLAYER_B_NOOP) : action;
+}
+
+// Applies an action for each player, see ale_interface.hpp.
+std::pair<reward_t, reward_t> ALEInterface::act(Action player_a_action,
+                                                Action player_b_action) {
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record player B's actions");
+  }
+  reward_t player_b_reward = 0;
+  reward_t player_a_reward = environment->act(
+      player_a_action, playerBAction(player_b_action), &player_b_reward);
+  return std::make_pair(player_a_reward, player_b_reward);
+}
+
+// Applies a sequence of actions in one call, see ale_interface.hpp.
+size_t ALEInterface::actSequence(const Action* actions, size_t n,
+                                 reward_t* rewards_out, bool stop_on_terminal,
+                                 bool suppress_observations) {
+  size_t terminal_index = environment->actSequence(
+      actions, n, rewards_out, stop_on_terminal, suppress_observations);
+  if (trajectory) {
+    // Only the steps that were taken
+    size_t taken = (stop_on_terminal && terminal_index < n) ? terminal_index + 1 : n;
+    trajectory->steps.insert(trajectory->steps.end(), actions, actions + taken);
+  }
+  return terminal_index;
+}
+
+size_t ALEInterface::actSequence(const Action* actions,
+                                 const Action* actions_b, size_t n,
+                                 reward_t* rewards_out,
+                                 reward_t* rewards_out_b,
+                                 bool stop_on_terminal,
+                                 bool suppress_observations) {
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record player B's actions");
+  }
+  std::vector<Action> player_b_actions(n);
+  std::transform(actions_b, actions_b + n, player_b_actions.begin(),
+                 playerBAction);
+  return environment->actSequence(actions, n, rewards_out, stop_on_terminal,
+                                  suppress_observations,
+                                  player_b_actions.data(), rewards_out_b);
+}
+
+reward_t ALEInterface::actContinuous(float paddle_position, bool fire) {
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record paddle positions");
+  }
+  return environment->actContinuous(paddle_position, fire);
+}
+
+size_t ALEInterface::actContinuousSequence(const float* paddle_positions,
+                                           const bool* fire, size_t n,
+                                           reward_t* rewards_out,
+                                           bool stop_on_terminal,
+                                           bool suppress_observations) {
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record paddle positions");
+  }
+  std::vector<Action> actions(n, PLAYER_A_NOOP);
+  if (fire != nullptr) {
+    for (size_t i = 0; i < n; i++) {
+      actions[i] = fire[i] ? PLAYER_A_FIRE : PLAYER_A_NOOP;
+    }
+  }
+  return environment->actSequence(actions.data(), n, rewards_out,
+                                  stop_on_terminal, suppress_observations,
+                                  NULL, NULL, paddle_positions);
+}
+
 // Returns the vector of modes available for the current game.
 // This should be called only after the rom is loaded.
 ModeVect ALEInterface::getAvailableModes() {
@@ -268,6 +406,9 @@ ModeVect ALEInterface::getAvailableModes() {
 // The mode must be an available mode.
 // This should be called only after the rom is loaded.
 void ALEInterface::setMode(game_mode_t m) {
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record mode changes");
+  }
   //We first need to make sure m is an available mode
   ModeVect available = romSettings->getAvailableModes();
   if (find(available.begin(), available.end(), m) != available.end()) {
@@ -287,6 +428,9 @@ DifficultyVect ALEInterface::getAvailableDifficulties() {
 // The difficulty must be an available mode.
 // This should be called only after the rom is loaded.
 void ALEInterface::setDifficulty(difficulty_t m) {
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record difficulty changes");
+  }
   DifficultyVect available = romSettings->getAvailableDifficulties();
   if (find(available.begin(), available.end(), m) != available.end()) {
     environment->setDifficulty(m);
@@ -353,6 +497,12 @@ void ALEInterface::getScreenRGB(std::vector<unsigned char>& output_rgb_buffer) {
                                               ale_screen_data, screen_size);
 }
 
+// Fills the buffer with the last frame's sound samples.
+void ALEInterface::getAudioFrame(std::vector<uint8_t>& output_buffer) {
+  const std::vector<uint8_t>& samples = theOSystem->sound().frameSamples();
+  output_buffer.assign(samples.begin(), samples.end());
+}
+
 // Returns the current RAM content
 const ALERAM& ALEInterface::getRAM() { return environment->getRAM(); }
 
@@ -361,6 +511,9 @@ void ALEInterface::setRAM(size_t memory_index, byte_t value) {
   if (memory_index < 0 || memory_index >= 128){
       throw std::runtime_error("setRAM index out of bounds.");
   }
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record RAM writes");
+  }
   return environment->setRAM(memory_index, value);
 }
 
@@ -369,6 +522,9 @@ ALEState ALEInterface::cloneState(bool include_rng) {
 }
 
 void ALEInterface::restoreState(const ALEState& state) {
+  if (trajectory) {
+    throw std::runtime_error("Trajectories don't record restored states");
+  }
   return environment->restoreState(state);
 }
 
@@ -390,4 +546,186 @@ ALEInterface::createScreenExporter(const std::string& filename) const {
   return new ScreenExporter(theOSystem->colourPalette(), filename);
 }
 
+std::map<std::string, size_t> ALEInterface::memoryFootprint() const {
+  std::map<std::string, size_t> footprint;
+  footprint["settings"] = theSettings->memoryUsage();
+  footprint["properties"] = theOSystem->propSet().memoryUsage();
+
+  if (theOSystem->hasConsole()) {
+    System& system = theOSystem->console().system();
+    footprint["system"] =
+        sizeof(System) + system.numberOfPages() * sizeof(System::PageAccess);
+    footprint["tia"] = sizeof(TIA) + 2 * system.tia().frameBufferSize();
+  }
+  if (environment) {
+    environment->memoryFootprint(footprint);
+  }
+
+  size_t total = 0;
+  for (const auto& entry : footprint) {
+    if (entry.first != "shared") {
+      total += entry.second;
+    }
+  }
+  footprint["total"] = total;
+  return footprint;
+}
+
+void ALEInterface::enableTracing(size_t events_per_thread) {
+  Trace::enable(events_per_thread);
+}
+
+void ALEInterface::disableTracing() { Trace::disable(); }
+
+// Writes the trace of every thread, see common/Trace.hpp.
+void ALEInterface::dumpTrace(const fs::path& path, bool clear) {
+  std::ofstream out(path);
+  if (!out) {
+    throw std::runtime_error("Unable to write trace to " + path.string());
+  }
+
+  Trace::dump(out);
+  if (clear) {
+    Trace::clear();
+  }
+}
+
+// Starts logging a trajectory, see ale_interface.hpp.
+void ALEInterface::startTrajectory() {
+  if (!environment) {
+    throw std::runtime_error("ROM not set");
+  }
+
+  if (environment->hasStartStates()) {
+    throw std::runtime_error("Start states can't be logged in a trajectory");
+  }
+
+  // Cached resets restore the emulator's randomness from when they were
+  // first emulated, which the replay's own empty cache wouldn't know
+  environment->clearResetCache();
+
+  trajectory = std::make_unique<Trajectory>();
+  trajectory->rom_md5 = theOSystem->console().properties().get(Cartridge_MD5);
+  for (const std::string& key : Trajectory::recordedSettings()) {
+    trajectory->settings.emplace_back(key, getString(key));
+  }
+  trajectory->initial_state = environment->cloneState(true);
+  trajectory->last_player_a_action = environment->getLastPlayerAAction();
+  trajectory->last_player_b_action = environment->getLastPlayerBAction();
+}
+
+Trajectory ALEInterface::stopTrajectory() {
+  if (!trajectory) {
+    throw std::runtime_error("No trajectory is being logged");
+  }
+
+  Trajectory result = std::move(*trajectory);
+  trajectory.reset();
+  return result;
+}
+
+// Replays one trajectory from start to end in a fresh environment.
+static void replayTrajectory(const Trajectory& trajectory, size_t index,
+                             const fs::path& rom_file,
+                             const ALEInterface::ReplayCallback& on_step) {
+  ALEInterface ale;
+  // Set through the untyped interface, as the values were saved as strings
+  for (const auto& setting : trajectory.settings) {
+    SettingType id = Settings::lookup(setting.first);
+    if (id == LastSettingType) {
+      throw std::runtime_error("Unknown setting " + setting.first +
+                               " in trajectory");
+    }
+    ale.theSettings->setString(id, setting.second);
+  }
+  ale.loadROM(rom_file);
+  if (ale.theOSystem->console().properties().get(Cartridge_MD5) !=
+      trajectory.rom_md5) {
+    throw std::runtime_error(rom_file.string() +
+                             " isn't the ROM the trajectory was logged with");
+  }
+
+  ale.restoreState(trajectory.initial_state);
+  // Sticky actions repeat the previous actions, which aren't in the state
+  ale.environment->setLastActions(trajectory.last_player_a_action,
+                                  trajectory.last_player_b_action);
+
+  size_t step = 0;
+  for (uint8_t value : trajectory.steps) {
+    if (value == Trajectory::RESET_STEP) {
+      ale.reset_game();
+    } else {
+      reward_t reward = ale.act((Action)value);
+      on_step(index, step++, reward, ale);
+    }
+  }
+}
+
+void ALEInterface::replayTrajectories(const std::vector<Trajectory>& trajectories,
+                                      const fs::path& rom_file,
+                                      const ReplayCallback& on_step,
+                                      size_t threads) {
+  ThreadPool::run(trajectories.size(), threads, [&](size_t, size_t i) {
+    replayTrajectory(trajectories[i], i, rom_file, on_step);
+  });
+}
+
+std::map<std::string, double>
+ALEInterface::profileROM(const fs::path& rom_file, int frames) {
+  if (frames < 1) {
+    throw std::runtime_error("Can't profile a ROM over fewer than 1 frame");
+  }
+  ALEInterface ale;
+  ale.setInt("random_seed", 0);
+  ale.loadROM(rom_file);
+
+  const ActionVect actions = ale.getMinimalActionSet();
+  std::mt19937 rng(0);
+  const int start_frame = ale.getFrameNumber();
+  ale.resetPerfStats();
+
+  // Resets are timed too, they're part of what a training loop pays for
+  auto start = std::chrono::steady_clock::now();
+  while (ale.getFrameNumber() - start_frame < frames) {
+    ale.act(actions[rng() % actions.size()]);
+    if (ale.game_over()) ale.reset_game();
+  }
+  double ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - start).count();
+
+  const double emulated = ale.getFrameNumber() - start_frame;
+  std::map<std::string, double> profile;
+  profile["frames"] = emulated;
+  profile["ns_per_frame"] = ns / emulated;
+
+  if (PerfStats::enabled()) {
+    std::map<std::string, uint64_t> stats = ale.getPerfStats();
+    profile["cpu_instructions_per_frame"] =
+        stats["cpu_instructions"] / emulated;
+    profile["tia_clocks_per_frame"] = stats["tia_clocks"] / emulated;
+    profile["bank_switches_per_frame"] = stats["bank_switches"] / emulated;
+
+    double device = stats["device_peeks"] + stats["device_pokes"];
+    double direct = stats["direct_peeks"] + stats["direct_pokes"];
+    profile["device_access_ratio"] =
+        device + direct > 0 ? device / (device + direct) : 0.0;
+  }
+  return profile;
+}
+
+// Returns the hot-path counters, see common/PerfCounters.hpp.
+std::map<std::string, uint64_t> ALEInterface::getPerfStats() const {
+  std::map<std::string, uint64_t> stats;
+  if (PerfStats::enabled() && theOSystem->hasConsole()) {
+    theOSystem->console().system().perfStats().toMap(stats);
+  }
+  return stats;
+}
+
+void ALEInterface::resetPerfStats() {
+  if (theOSystem->hasConsole()) {
+    theOSystem->console().system().perfStats().reset();
+  }
+}
+
 }  // namespace ale
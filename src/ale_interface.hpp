@@ -34,12 +34,17 @@
 #include "emucore/OSystem.hxx"
 #include "games/Roms.hpp"
 #include "environment/stella_environment.hpp"
+#include "environment/trajectory.hpp"
 #include "common/ScreenExporter.hpp"
 #include "common/Log.hpp"
 #include "version.hpp"
 
+#include <functional>
+#include <map>
 #include <string>
 #include <optional>
+#include <utility>
+#include <vector>
 #include <memory>
 #include <filesystem>
 
@@ -88,12 +93,62 @@ class ALEInterface {
   // game over screen.
   reward_t act(Action action);
 
+  // Applies an action for each of the two players and returns their
+  // rewards, player A's first. Player B's action may be given as a PLAYER_A_*
+  // or PLAYER_B_* value. Player B only has a reward in games two players
+  // can play against each other (Boxing, Pong, Surround and Tennis), where
+  // it is the opposite of player A's. None of the modes getAvailableModes()
+  // offers for these games is a two-player one, so player B's action
+  // doesn't affect the game yet and its reward is the CPU opponent's.
+  std::pair<reward_t, reward_t> act(Action player_a_action,
+                                    Action player_b_action);
+
+  // Applies the n actions in turn, as n calls to act() would, and stores the
+  // reward of each in rewards_out if it isn't null. Returns the index of the
+  // action that ended the episode, or n if it didn't end. With
+  // stop_on_terminal the remaining actions are skipped and their rewards set
+  // to zero. Unless suppress_observations is false the screen and RAM are
+  // only updated after the last action; the final observation is unchanged.
+  size_t actSequence(const Action* actions, size_t n, reward_t* rewards_out,
+                     bool stop_on_terminal = true,
+                     bool suppress_observations = true);
+
+  // Same as above for two players, with the actions and rewards of player B
+  // in the arrays ending in _b.
+  size_t actSequence(const Action* actions, const Action* actions_b, size_t n,
+                     reward_t* rewards_out, reward_t* rewards_out_b,
+                     bool stop_on_terminal = true,
+                     bool suppress_observations = true);
+
+  // Moves player A's paddle straight to paddle_position, from 0 (leftmost)
+  // to 1 (rightmost), instead of by PADDLE_DELTA per frame, then presses fire
+  // or does nothing for the step, as act() would. The paddle moves at once,
+  // while the fire button is subject to sticky actions. Throws if the game
+  // doesn't use paddles, or if a trajectory is being logged.
+  reward_t actContinuous(float paddle_position, bool fire = false);
+
+  // Applies the n paddle positions in turn, as n calls to actContinuous()
+  // would, pressing fire at the steps where fire is set (never if it is
+  // null). Rewards and the return value are as for actSequence().
+  size_t actContinuousSequence(const float* paddle_positions, const bool* fire,
+                               size_t n, reward_t* rewards_out,
+                               bool stop_on_terminal = true,
+                               bool suppress_observations = true);
+
   // Indicates if the game has ended.
   bool game_over() const;
 
-  // Resets the game, but not the full system.
+  // Resets the game, but not the full system. The noop_max and
+  // cache_resets settings and setStartStates() randomize the start of the
+  // episode and cache it.
   void reset_game();
 
+  // Makes reset_game() start each episode from one of these states, drawn
+  // at random, e.g. states taken from human play for the "human starts"
+  // evaluation protocol. They should be cloned without the RNG. An empty
+  // list restores the usual reset. Loading a ROM discards them.
+  void setStartStates(const std::vector<ALEState>& states);
+
   // Returns the vector of modes available for the current game.
   // This should be called only after the rom is loaded.
   ModeVect getAvailableModes();
@@ -158,6 +213,11 @@ class ALEInterface {
   //followed by the green colours and then the blue colours
   void getScreenRGB(std::vector<unsigned char>& output_rgb_buffer);
 
+  // Fills the buffer with the sound samples of the last emulated frame
+  // (unsigned 8-bit, mono). The buffer is left empty unless the sound_obs
+  // setting was enabled when the ROM was loaded.
+  void getAudioFrame(std::vector<uint8_t>& output_buffer);
+
   // Returns the current RAM content
   const ALERAM& getRAM();
 
@@ -192,16 +252,90 @@ class ALEInterface {
   // to exists.
   ScreenExporter* createScreenExporter(const std::string& path) const;
 
+  // Returns the approximate number of bytes used by this interface, broken
+  // down per subsystem. The "total" entry sums the per-instance entries;
+  // "shared" counts immutable tables shared with other instances and is not
+  // part of the total.
+  std::map<std::string, size_t> memoryFootprint() const;
+
+  // Returns the hot-path counters (instructions, TIA clocks, bank switches,
+  // device and direct memory accesses) and timers (screen and RAM
+  // processing, game step) accumulated since the ROM was loaded or
+  // resetPerfStats() was called. Empty unless the library was built with
+  // PERF_COUNTERS.
+  std::map<std::string, uint64_t> getPerfStats() const;
+
+  // Zeroes the counters returned by getPerfStats().
+  void resetPerfStats();
+
+  // Starts recording a timeline of environment calls (act, emulate, reset,
+  // softReset, cloneState, restoreState, screen export) from every thread,
+  // keeping the last events_per_thread events of each.
+  static void enableTracing(size_t events_per_thread = 1 << 16);
+
+  // Stops recording; the events recorded so far can still be dumped.
+  static void disableTracing();
+
+  // Writes the recorded events as Chrome trace JSON, which can be opened in
+  // chrome://tracing or Perfetto. Clears them if clear is set.
+  static void dumpTrace(const fs::path& path, bool clear = false);
+
+  // Starts logging a trajectory: the ROM, the settings that affect
+  // emulation, the current state (RNG included) and every action and
+  // reset_game() from now on. Loading a ROM discards it. While it is being
+  // logged, setMode, setDifficulty, setRAM, restoreState and
+  // restoreSystemState throw, as the trajectory couldn't replay them.
+  void startTrajectory();
+
+  // Stops logging and returns the trajectory, which can be saved to a file
+  // and replayed. Throws if no trajectory is being logged.
+  Trajectory stopTrajectory();
+
+  // Whether a trajectory is being logged.
+  bool isLoggingTrajectory() const { return trajectory != nullptr; }
+
+  // Replays each trajectory in an environment of its own, spread over
+  // `threads` threads (0 uses all hardware threads). After every action,
+  // on_step is called from the replaying thread with the index of the
+  // trajectory, the index of the action in it, the reward and the
+  // environment, which holds the same observations as when the trajectory
+  // was logged. Throws if rom_file isn't the trajectory's ROM.
+  using ReplayCallback = std::function<void(size_t trajectory, size_t step,
+                                            reward_t reward, ALEInterface& ale)>;
+  static void replayTrajectories(const std::vector<Trajectory>& trajectories,
+                                 const fs::path& rom_file,
+                                 const ReplayCallback& on_step,
+                                 size_t threads = 0);
+
  public:
   std::unique_ptr<stella::OSystem> theOSystem;
   std::unique_ptr<stella::Settings> theSettings;
   std::unique_ptr<RomSettings> romSettings;
   std::unique_ptr<StellaEnvironment> environment;
+  std::unique_ptr<Trajectory> trajectory; // Being logged, if any
   int max_num_frames; // Maximum number of frames for each episode
 
  public:
   // Check if the rom with filename matches a supported MD5
   static std::optional<std::string> isSupportedROM(const fs::path& rom_file);
+  // Checks every file against the supported MD5s using `threads` worker
+  // threads (0 uses all hardware threads). Maps each file to its ROM id,
+  // or to nullopt if the file is unsupported or can't be read.
+  static std::map<fs::path, std::optional<std::string>>
+  scanROMs(const std::vector<fs::path>& rom_files, size_t threads = 0);
+  // Same as scanROMs for all the .bin files directly inside `directory`.
+  static std::map<fs::path, std::optional<std::string>>
+  scanROMDirectory(const fs::path& directory, size_t threads = 0);
+  // Measures how expensive a ROM is to emulate by playing random actions
+  // from its minimal action set for at least `frames` frames, resetting at
+  // the end of each episode. Reports "frames" and "ns_per_frame"; builds
+  // with PERF_COUNTERS also report "cpu_instructions_per_frame",
+  // "tia_clocks_per_frame", "bank_switches_per_frame" and
+  // "device_access_ratio", the fraction of memory accesses dispatched to a
+  // device rather than served from memory. Throws std::runtime_error if
+  // `frames` is less than 1.
+  static std::map<std::string, double> profileROM(const fs::path& rom_file,
+                                                  int frames = 2000);
   // Display ALE welcome message
   static std::string welcomeMessage();
   static void disableBufferedIO();
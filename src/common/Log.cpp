@@ -1,16 +1,166 @@
 #include "common/Log.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <stdexcept>
 
 namespace ale {
 
-Logger::mode Logger::current_mode = Info;
+std::atomic<Logger::mode> Logger::current_mode(Info);
+
+namespace {
+
+std::atomic<Logger::format> sink_format(Logger::Text);
+std::atomic<FILE*> sink_file(nullptr);  // stderr when null
+std::atomic<int> rate_limit(0);
+
+// The rate limit counts lines in one-second windows
+std::atomic<int64_t> window_second(0);
+std::atomic<int> window_lines(0);
+std::atomic<int> dropped_lines(0);
+
+std::atomic<int> next_thread(0);
+
+// Collects what a thread writes at one level, and hands each complete line
+// to Logger::write
+class LineBuffer : public std::streambuf {
+ public:
+  explicit LineBuffer(Logger::mode m) : m_mode(m) {}
+
+  ~LineBuffer() override {
+    if (!m_line.empty()) Logger::write(m_mode, m_line);
+  }
+
+ protected:
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+    if (c == '\n') {
+      Logger::write(m_mode, m_line);
+      m_line.clear();
+    } else {
+      m_line += traits_type::to_char_type(c);
+    }
+    return c;
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    for (std::streamsize i = 0; i < n; i++) {
+      overflow(traits_type::to_int_type(s[i]));
+    }
+    return n;
+  }
+
+ private:
+  Logger::mode m_mode;
+  std::string m_line;
+};
+
+struct ThreadLog {
+  ThreadLog(Logger::mode m) : buffer(m), stream(&buffer) {}
+
+  LineBuffer buffer;
+  std::ostream stream;
+};
+
+void appendJSONString(std::string& out, const std::string& s) {
+  out += '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if ((unsigned char)c < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+// Formats a line and writes it with a single call, which stdio makes atomic
+// with respect to other threads
+void emit(Logger::mode m, const std::string& line) {
+  static const char* level_names[] = {"info", "warning", "error"};
+  thread_local const int thread = next_thread++;
+
+  std::string out;
+  if (sink_format.load(std::memory_order_relaxed) == Logger::JSONLines) {
+    if (line.empty()) return;  // Blank lines only space out text logs
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    char prefix[64];
+    std::snprintf(prefix, sizeof(prefix), "{\"time\": %.6f, \"level\": \"%s\"",
+                  std::chrono::duration<double>(now).count(), level_names[m]);
+    out = prefix;
+    out += ", \"thread\": " + std::to_string(thread) + ", \"message\": ";
+    appendJSONString(out, line);
+    out += "}\n";
+  } else {
+    out = line + '\n';
+  }
+
+  FILE* file = sink_file.load();
+  std::fwrite(out.data(), 1, out.size(), file != nullptr ? file : stderr);
+}
+
+}  // namespace
 
 void Logger::setMode(Logger::mode m) { current_mode = m; }
 
+void Logger::setFormat(Logger::format f) { sink_format = f; }
+
+void Logger::setFile(const std::string& path) {
+  FILE* file = nullptr;
+  if (!path.empty()) {
+    file = std::fopen(path.c_str(), "a");
+    if (file == nullptr) {
+      throw std::runtime_error("Could not open " + path + " for logging");
+    }
+  }
+  FILE* previous = sink_file.exchange(file);
+  if (previous != nullptr) std::fclose(previous);
+}
+
+void Logger::setRateLimit(int lines_per_second) {
+  rate_limit = lines_per_second;
+}
+
+std::ostream& Logger::stream(Logger::mode m) {
+  thread_local ThreadLog logs[] = {Info, Warning, Error};
+  return logs[m].stream;
+}
+
+void Logger::write(Logger::mode m, const std::string& line) {
+  const int limit = rate_limit.load(std::memory_order_relaxed);
+  if (limit > 0 && m != Error) {
+    int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t window = window_second.load();
+    if (second != window && window_second.compare_exchange_strong(window, second)) {
+      window_lines = 0;
+      int dropped = dropped_lines.exchange(0);
+      if (dropped > 0) {
+        emit(Warning, "Rate limit dropped " + std::to_string(dropped) +
+                          " log lines");
+      }
+    }
+    if (window_lines++ >= limit) {
+      dropped_lines++;
+      return;
+    }
+  }
+  emit(m, line);
+}
+
 Logger::mode operator<<(Logger::mode log, std::ostream& (*manip)(std::ostream&)) {
-  if (log >= Logger::current_mode) {
-    manip(std::cerr);
+  if (Logger::enabled(log)) {
+    manip(Logger::stream(log));
   }
   return log;
 }
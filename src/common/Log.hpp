@@ -1,30 +1,67 @@
 #ifndef __LOG_HPP__
 #define __LOG_HPP__
 
+#include <atomic>
 #include <iostream>
+#include <string>
 
 namespace ale {
 
+/** Messages are written with `Logger::Info << ... << std::endl`. Each thread
+ *  collects what it writes in buffers of its own and hands complete lines to
+ *  the sink in a single write, so lines from different threads don't
+ *  interleave and no lock is taken while formatting. Nothing is formatted
+ *  for levels below the current mode; guard messages that are expensive to
+ *  build with Logger::enabled().
+ */
 class Logger {
  public:
   enum mode { Info = 0, Warning = 1, Error = 2 };
+  enum format { Text = 0, JSONLines = 1 };
+
   /** @brief Allow to change the level of verbosity
    *  @param m Info will print all the messages, Warning only the important ones
    *  and Error the critical ones
    */
   static void setMode(mode m);
 
+  /** @brief Whether messages of the given level are written */
+  static bool enabled(mode m) {
+    return m >= current_mode.load(std::memory_order_relaxed);
+  }
+
+  /** @brief Chooses between plain lines and JSON lines holding the time,
+   *  level, a thread number and the message
+   */
+  static void setFormat(format f);
+
+  /** @brief Appends messages to a file rather than stderr; an empty path
+   *  restores stderr. Call it before other threads log. Throws
+   *  std::runtime_error if the file can't be opened.
+   */
+  static void setFile(const std::string& path);
+
+  /** @brief Writes at most n Info and Warning lines per second across all
+   *  threads, reporting how many were dropped; 0 (the default) removes the
+   *  limit. Errors are never dropped.
+   */
+  static void setRateLimit(int lines_per_second);
+
+  /** @brief The calling thread's stream for messages of the given level */
+  static std::ostream& stream(mode m);
+
+  /** @brief Writes a complete line to the sink */
+  static void write(mode m, const std::string& line);
+
  private:
-  static mode current_mode;
-  friend mode operator<<(mode, std::ostream& (*manip)(std::ostream&));
-  template <typename T> friend mode operator<<(mode, const T&);
+  static std::atomic<mode> current_mode;
 };
 
 Logger::mode operator<<(Logger::mode log,
                         std::ostream& (*manip)(std::ostream&));
 
 template <typename T> Logger::mode operator<<(Logger::mode log, const T& val) {
-  if (log >= Logger::current_mode) std::cerr << val;
+  if (Logger::enabled(log)) Logger::stream(log) << val;
   return log;
 }
 
@@ -0,0 +1,77 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  MappedFile.cpp
+ *
+ *  Read-only view of a whole file, memory mapped where the platform allows.
+ **************************************************************************** */
+#include "common/MappedFile.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#if !defined(WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace ale {
+
+MappedFile::MappedFile(const fs::path& path)
+    : m_data(nullptr), m_size(0), m_good(false), m_mapped(false) {
+#if !defined(WIN32)
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    m_size = st.st_size;
+    if (m_size == 0) {
+      m_good = true;
+    } else {
+      void* addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        m_data = static_cast<const uint8_t*>(addr);
+        m_good = m_mapped = true;
+      }
+    }
+  }
+  close(fd);
+  if (m_good) {
+    return;
+  }
+  m_size = 0;
+#endif
+
+  // Fall back to reading the whole file
+  std::ifstream fsnode(path, std::ios::binary);
+  if (!fsnode.good()) {
+    return;
+  }
+  m_buffer.assign(std::istreambuf_iterator<char>(fsnode),
+                  std::istreambuf_iterator<char>());
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+  m_good = !fsnode.bad();
+}
+
+MappedFile::~MappedFile() {
+#if !defined(WIN32)
+  if (m_mapped) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+#endif
+}
+
+} // namespace ale
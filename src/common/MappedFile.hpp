@@ -0,0 +1,53 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  MappedFile.hpp
+ *
+ *  Read-only view of a whole file, memory mapped where the platform allows.
+ **************************************************************************** */
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace ale {
+
+class MappedFile {
+ public:
+  /* Maps the file at `path`; check good() before using the contents. */
+  explicit MappedFile(const fs::path& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /* Whether the file was opened and read successfully. */
+  bool good() const { return m_good; }
+
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+ private:
+  const uint8_t* m_data;
+  size_t m_size;
+  bool m_good;
+  bool m_mapped;
+
+  // Holds the contents when the file couldn't be mapped
+  std::vector<uint8_t> m_buffer;
+};
+
+} // namespace ale
+#endif // MAPPED_FILE_HPP
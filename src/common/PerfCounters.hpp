@@ -0,0 +1,118 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  PerfCounters.hpp
+ *
+ *  Counters and timers on the emulator's hot paths. They are only updated
+ *  when the library is built with ALE_PERF_COUNTERS (the PERF_COUNTERS cmake
+ *  option); otherwise the ALE_PERF_* macros expand to nothing.
+ **************************************************************************** */
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace ale {
+
+enum PerfCounter {
+  PERF_CPU_INSTRUCTIONS,  // Instructions run by M6502::execute
+  PERF_TIA_CLOCKS,        // Colour clocks drawn by TIA::updateFrame
+  PERF_BANK_SWITCHES,     // Bank switches done by the cartridge
+  PERF_DEVICE_PEEKS,      // System::peek calls dispatched to a device
+  PERF_DIRECT_PEEKS,      // System::peek calls served from memory
+  PERF_DEVICE_POKES,      // System::poke calls dispatched to a device
+  PERF_DIRECT_POKES,      // System::poke calls served from memory
+  PERF_NUM_COUNTERS
+};
+
+enum PerfTimer {
+  PERF_PROCESS_SCREEN,  // StellaEnvironment::processScreen
+  PERF_PROCESS_RAM,     // StellaEnvironment::processRAM
+  PERF_ROM_STEP,        // RomSettings::step
+  PERF_NUM_TIMERS
+};
+
+struct PerfStats {
+  uint64_t counters[PERF_NUM_COUNTERS];
+  uint64_t timer_ns[PERF_NUM_TIMERS];
+  uint64_t timer_calls[PERF_NUM_TIMERS];
+
+  PerfStats() { reset(); }
+
+  void reset() {
+    for (uint64_t& c : counters) c = 0;
+    for (uint64_t& t : timer_ns) t = 0;
+    for (uint64_t& t : timer_calls) t = 0;
+  }
+
+  /** Whether the counters were compiled in. */
+  static constexpr bool enabled() {
+#ifdef ALE_PERF_COUNTERS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /** Adds every counter, and the total time and number of calls of every
+   *  timer, to stats under its name, e.g. "cpu_instructions",
+   *  "process_screen_ns" and "process_screen_calls". */
+  void toMap(std::map<std::string, uint64_t>& stats) const {
+    static const char* counter_names[PERF_NUM_COUNTERS] = {
+        "cpu_instructions", "tia_clocks",   "bank_switches", "device_peeks",
+        "direct_peeks",     "device_pokes", "direct_pokes"};
+    static const char* timer_names[PERF_NUM_TIMERS] = {
+        "process_screen", "process_ram", "rom_step"};
+
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+      stats[counter_names[i]] = counters[i];
+    }
+    for (int i = 0; i < PERF_NUM_TIMERS; i++) {
+      stats[std::string(timer_names[i]) + "_ns"] = timer_ns[i];
+      stats[std::string(timer_names[i]) + "_calls"] = timer_calls[i];
+    }
+  }
+};
+
+/** Adds the time until the end of the enclosing scope to a timer. */
+class PerfScope {
+ public:
+  PerfScope(PerfStats& stats, PerfTimer timer)
+      : m_stats(stats), m_timer(timer),
+        m_start(std::chrono::steady_clock::now()) {}
+
+  ~PerfScope() {
+    m_stats.timer_ns[m_timer] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start).count();
+    m_stats.timer_calls[m_timer]++;
+  }
+
+ private:
+  PerfStats& m_stats;
+  PerfTimer m_timer;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace ale
+
+#ifdef ALE_PERF_COUNTERS
+#define ALE_PERF_COUNT(stats, counter, n) ((stats).counters[counter] += (n))
+#define ALE_PERF_TIME(stats, timer) \
+  ::ale::PerfScope ale_perf_scope_##timer((stats), (timer))
+#else
+#define ALE_PERF_COUNT(stats, counter, n) ((void)0)
+#define ALE_PERF_TIME(stats, timer) ((void)0)
+#endif
+
+#endif  // PERF_COUNTERS_HPP
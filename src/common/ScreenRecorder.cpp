@@ -0,0 +1,150 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ScreenRecorder.cpp
+ *
+ *  Streams delta-coded, zlib compressed frames to a single file.
+ **************************************************************************** */
+
+#include "common/ScreenRecorder.hpp"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "common/Log.hpp"
+
+namespace ale {
+
+static void writeUInt32(std::ofstream& out, uint32_t value) {
+  uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                      (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  out.write((const char*)bytes, sizeof(bytes));
+}
+
+ScreenRecorder::ScreenRecorder(const ColourPalette& palette,
+                               const std::string& filename, size_t height,
+                               size_t width, size_t frames_per_chunk,
+                               size_t max_queued_frames)
+    : m_out(filename.c_str(), std::ios_base::binary),
+      m_frame_size(height * width),
+      m_frames_per_chunk(std::max<size_t>(frames_per_chunk, 1)),
+      m_max_queued_frames(std::max<size_t>(max_queued_frames, 1)),
+      m_done(false),
+      m_chunk_frames(0) {
+  if (!m_out.good()) {
+    throw std::runtime_error("Could not open " + filename + " for writing");
+  }
+
+  m_out.write("ALEV", 4);
+  writeUInt32(m_out, 1);
+  writeUInt32(m_out, width);
+  writeUInt32(m_out, height);
+  for (int i = 0; i < 256; i++) {
+    // Odd values never appear on screen; give them their even neighbour's colour
+    int r, g, b;
+    palette.getRGB(i & ~1, r, g, b);
+    uint8_t rgb[3] = {(uint8_t)r, (uint8_t)g, (uint8_t)b};
+    m_out.write((const char*)rgb, sizeof(rgb));
+  }
+
+  m_previous.resize(m_frame_size);
+  m_chunk.reserve(m_frame_size * m_frames_per_chunk);
+  m_thread = std::thread(&ScreenRecorder::run, this);
+}
+
+ScreenRecorder::~ScreenRecorder() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_done = true;
+  }
+  m_not_empty.notify_one();
+  m_thread.join();
+}
+
+void ScreenRecorder::record(const ALEScreen& screen) {
+  std::vector<uint8_t> frame;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this] { return m_queue.size() < m_max_queued_frames; });
+    if (!m_free.empty()) {
+      frame.swap(m_free.back());
+      m_free.pop_back();
+    }
+  }
+
+  // Copy outside the lock so the encoder isn't held up
+  frame.assign(screen.getArray(), screen.getArray() + m_frame_size);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(std::move(frame));
+  }
+  m_not_empty.notify_one();
+}
+
+void ScreenRecorder::run() {
+  std::vector<uint8_t> frame;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (!frame.empty()) {
+        m_free.push_back(std::move(frame));
+        frame = std::vector<uint8_t>();
+      }
+
+      m_not_empty.wait(lock, [this] { return m_done || !m_queue.empty(); });
+      if (m_queue.empty()) break;  // Done, and everything is encoded
+
+      frame.swap(m_queue.front());
+      m_queue.pop_front();
+    }
+    m_not_full.notify_one();
+
+    // Delta code against the previous frame of this chunk
+    if (m_chunk_frames == 0) {
+      std::memset(m_previous.data(), 0, m_frame_size);
+    }
+    size_t offset = m_chunk.size();
+    m_chunk.resize(offset + m_frame_size);
+    for (size_t i = 0; i < m_frame_size; i++) {
+      m_chunk[offset + i] = frame[i] ^ m_previous[i];
+    }
+    m_previous.swap(frame);
+
+    if (++m_chunk_frames == m_frames_per_chunk) {
+      writeChunk();
+    }
+  }
+
+  writeChunk();
+  m_out.close();
+}
+
+void ScreenRecorder::writeChunk() {
+  if (m_chunk_frames == 0) return;
+
+  uLongf compressed_size = compressBound(m_chunk.size());
+  m_compressed.resize(compressed_size);
+  if (compress2(m_compressed.data(), &compressed_size, m_chunk.data(),
+                m_chunk.size(), Z_BEST_SPEED) != Z_OK) {
+    Logger::Error << "Error: Couldn't compress recorded frames\n";
+  } else {
+    writeUInt32(m_out, m_chunk_frames);
+    writeUInt32(m_out, compressed_size);
+    m_out.write((const char*)m_compressed.data(), compressed_size);
+  }
+
+  m_chunk.clear();
+  m_chunk_frames = 0;
+}
+
+}  // namespace ale
@@ -0,0 +1,93 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ScreenRecorder.hpp
+ *
+ *  Records a stream of frames to a single file. Frames are encoded on a
+ *  background thread, so recording costs the emulation thread a copy of
+ *  the screen.
+ *
+ *  File layout, all integers little-endian:
+ *    "ALEV", uint32 version (1), uint32 width, uint32 height,
+ *    768 bytes of palette (RGB for each of the 256 pixel values),
+ *    then chunks of: uint32 frame count, uint32 compressed size, and the
+ *    zlib compressed frames. Each frame is width * height palette indices
+ *    XORed with the previous frame of its chunk (the first against zero),
+ *    so chunks decode independently.
+ *
+ *  `ale-convert-recording` turns these files into PNGs or a video.
+ **************************************************************************** */
+
+#ifndef __SCREEN_RECORDER_HPP__
+#define __SCREEN_RECORDER_HPP__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/ColourPalette.hpp"
+#include "environment/ale_screen.hpp"
+
+namespace ale {
+
+class ScreenRecorder {
+ public:
+  /** Creates the file and writes its header; throws std::runtime_error if
+   *  the file can't be created. */
+  ScreenRecorder(const ColourPalette& palette, const std::string& filename,
+                 size_t height, size_t width, size_t frames_per_chunk = 64,
+                 size_t max_queued_frames = 256);
+
+  /** Encodes the frames still queued and closes the file. */
+  ~ScreenRecorder();
+
+  ScreenRecorder(const ScreenRecorder&) = delete;
+  ScreenRecorder& operator=(const ScreenRecorder&) = delete;
+
+  /** Queues a frame, waiting for the encoder if the queue is full. */
+  void record(const ALEScreen& screen);
+
+ private:
+  /** The encoder thread. */
+  void run();
+
+  /** Compresses and writes out the frames accumulated in m_chunk. */
+  void writeChunk();
+
+  std::ofstream m_out;
+  const size_t m_frame_size;
+  const size_t m_frames_per_chunk;
+  const size_t m_max_queued_frames;
+
+  // Shared with the encoder thread, guarded by m_mutex
+  std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+  std::deque<std::vector<uint8_t>> m_queue;
+  std::vector<std::vector<uint8_t>> m_free;  // Recycled frame buffers
+  bool m_done;
+
+  // Only used by the encoder thread
+  std::vector<uint8_t> m_previous;
+  std::vector<uint8_t> m_chunk;
+  std::vector<uint8_t> m_compressed;
+  uint32_t m_chunk_frames;
+
+  std::thread m_thread;
+};
+
+}  // namespace ale
+
+#endif  // __SCREEN_RECORDER_HPP__
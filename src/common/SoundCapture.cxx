@@ -0,0 +1,143 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll       
+//  SS  SS   tt           ll   ll        
+//  SS     tttttt  eeee   ll   ll   aaaa 
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+#include <algorithm>
+
+#include "emucore/Serializer.hxx"
+#include "emucore/Deserializer.hxx"
+#include "emucore/Settings.hxx"
+#include "common/SoundCapture.hxx"
+#include "common/Log.hpp"
+
+namespace ale {
+using namespace stella;   // Settings, Serializer, Deserializer, TIASound
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoundCapture::SoundCapture(Settings* settings)
+    : Sound(settings),
+      myTIASound(settings->getInt("freq"), settings->getInt("tiafreq"), 1),
+      myLastFrameEndCycle(0),
+      myFrameSamples(ale::sound::SoundExporter::SamplesPerFrame, 0)
+{
+  const std::string& filename = settings->getString(Setting_RecordSoundFilename);
+  if(!filename.empty())
+  {
+    mySoundExporter.reset(new ale::sound::SoundExporter(filename, 1));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoundCapture::~SoundCapture()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundCapture::adjustCycleCounter(int amount)
+{
+  for(RegWrite& write : myRegWrites)
+    write.cycle += amount;
+  myLastFrameEndCycle += amount;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundCapture::reset()
+{
+  myRegWrites.clear();
+  myTIASound.reset();
+  myLastFrameEndCycle = 0;
+  std::fill(myFrameSamples.begin(), myFrameSamples.end(), 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundCapture::set(uint16_t addr, uint8_t value, int cycle)
+{
+  myRegWrites.push_back({addr, value, cycle});
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundCapture::endFrame(int cycle)
+{
+  const int samples = (int)myFrameSamples.size();
+  const int frameCycles = cycle - myLastFrameEndCycle;
+
+  // Generate up to each register write in turn
+  int position = 0;
+  for(const RegWrite& write : myRegWrites)
+  {
+    int next = frameCycles > 0 ?
+        (int)((int64_t)(write.cycle - myLastFrameEndCycle) * samples / frameCycles) : 0;
+    next = std::min(std::max(next, position), samples);
+    myTIASound.process(myFrameSamples.data() + position, next - position);
+    myTIASound.set(write.addr, write.value);
+    position = next;
+  }
+  myTIASound.process(myFrameSamples.data() + position, samples - position);
+
+  myRegWrites.clear();
+  myLastFrameEndCycle = cycle;
+
+  if(mySoundExporter)
+    mySoundExporter->addSamples(myFrameSamples.data(), samples);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundCapture::load(Deserializer& in)
+{
+  std::string device = "TIASound";
+
+  try
+  {
+    if(in.getString() != device)
+      return false;
+
+    // Writes still pending belong to the frame we're leaving
+    myRegWrites.clear();
+    for(uint16_t addr = 0x15; addr <= 0x1a; ++addr)
+      myTIASound.set(addr, (uint8_t) in.getInt());
+
+    // myLastRegisterSetCycle
+    in.getInt();
+  }
+  catch(const char* msg)
+  {
+    ale::Logger::Error << msg << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundCapture::save(Serializer& out)
+{
+  out.putString("TIASound");
+
+  // The registers as of the end of the last frame, with this frame's
+  // writes applied
+  TIASound sound = myTIASound;
+  for(const RegWrite& write : myRegWrites)
+    sound.set(write.addr, write.value);
+  for(uint16_t addr = 0x15; addr <= 0x1a; ++addr)
+    out.putInt(sound.get(addr));
+
+  // myLastRegisterSetCycle
+  out.putInt(0);
+
+  return true;
+}
+
+}  // namespace ale
@@ -0,0 +1,149 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll       
+//  SS  SS   tt           ll   ll        
+//  SS     tttttt  eeee   ll   ll   aaaa 
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+#ifndef SOUND_CAPTURE_HXX
+#define SOUND_CAPTURE_HXX
+
+namespace ale {
+namespace stella {
+
+class Settings;
+class Serializer;
+class Deserializer;
+
+}  // namespace stella
+}  // namespace ale
+
+#include <memory>
+#include <vector>
+
+#include "emucore/Sound.hxx"
+#include "emucore/TIASnd.hxx"
+#include "common/SoundExporter.hpp"
+
+namespace ale {
+
+/**
+  This class generates the samples for every frame without playing them,
+  so they can be used as observations or written to a file without SDL.
+  Register writes are placed within the frame by the cycle they happen at.
+*/
+class SoundCapture : public stella::Sound
+{
+  public:
+    /**
+      Create a new sound object.  Samples are written to the file named by
+      the record_sound_filename setting, if any.
+    */
+    SoundCapture(stella::Settings* settings);
+
+    /**
+      Destructor
+    */
+    virtual ~SoundCapture();
+
+  public:
+    void setEnabled(bool) { }
+    void setChannels(uint32_t) { }
+    void setFrameRate(uint32_t) { }
+    void initialize() { }
+    void close() { }
+    bool isSuccessfullyInitialized() const { return true; }
+    void mute(bool) { }
+    void setVolume(int) { }
+    void adjustVolume(int8_t) { }
+
+    /**
+      Every frame is generated, so there is nothing to request.
+    */
+    void recordNextFrame() { }
+
+    /**
+      The system cycle counter is being adjusting by the specified amount.
+      The cycles of the pending register writes are adjusted to match.
+
+      @param amount The amount the cycle counter is being adjusted by
+    */
+    void adjustCycleCounter(int amount);
+
+    /**
+      Reset the sound device.
+    */
+    void reset();
+
+    /**
+      Queues a write to a sound register until the end of the frame.
+
+      @param addr  The register address
+      @param value The value to save into the register
+      @param cycle The system cycle at which the register is being updated
+    */
+    void set(uint16_t addr, uint8_t value, int cycle);
+
+    /**
+      Generates the samples of the frame that just ended.
+
+      @param cycle The system cycle at which the frame ended
+    */
+    void endFrame(int cycle);
+
+    const std::vector<uint8_t>& frameSamples() const { return myFrameSamples; }
+
+  public:
+    /**
+      Loads the current state of this device from the given Deserializer.
+
+      @param in The deserializer device to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    bool load(stella::Deserializer& in);
+
+    /**
+      Saves the current state of this device to the given Serializer.
+
+      @param out The serializer device to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    bool save(stella::Serializer& out);
+
+  private:
+    struct RegWrite
+    {
+      uint16_t addr;
+      uint8_t value;
+      int cycle;
+    };
+
+    // Generates the sound
+    stella::TIASound myTIASound;
+
+    // Register writes made during the current frame
+    std::vector<RegWrite> myRegWrites;
+
+    // The cycle at which the previous frame ended
+    int myLastFrameEndCycle;
+
+    // The samples of the last finished frame
+    std::vector<uint8_t> myFrameSamples;
+
+    // Writes the samples to a file, if requested
+    std::unique_ptr<ale::sound::SoundExporter> mySoundExporter;
+};
+
+}  // namespace ale
+
+#endif
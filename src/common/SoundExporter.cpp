@@ -9,56 +9,88 @@ namespace sound {
 // TODO(mgb): in reality this should be 31,400 Hz, but currently we are just short of this
 static const unsigned int SampleRate = 60 * SoundExporter::SamplesPerFrame;
 
-// Save wav file every 30 seconds
-static const unsigned int WriteInterval = SampleRate * 30;
+// Append to the file every second
+static const unsigned int FlushInterval = SampleRate;
+
+// Update the wav header every 30 seconds (to avoid cases where the destructor is not called)
+static const unsigned int HeaderInterval = SampleRate * 30;
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
 
 SoundExporter::SoundExporter(const std::string& filename, int channels)
-    : m_filename(filename), m_channels(channels), m_samples_since_write(0) {}
+    : m_stream(filename.c_str(), std::ios::binary),
+      m_wav(!endsWith(filename, ".raw")),
+      m_channels(channels),
+      m_samples_written(0),
+      m_samples_since_header(0) {
+  m_buffer.reserve(FlushInterval);
+  if (m_wav) {
+    writeWAVHeader();
+  }
+}
 
-SoundExporter::~SoundExporter() { writeWAVData(); }
+SoundExporter::~SoundExporter() {
+  flush();
+  if (m_wav) {
+    writeWAVHeader();
+  }
+}
 
 void SoundExporter::addSamples(SampleType* s, int len) {
   // @todo -- currently we only support mono recording
   assert(m_channels == 1);
 
-  for (int i = 0; i < len; i++)
-    m_data.push_back(s[i]);
+  m_buffer.insert(m_buffer.end(), s, s + len);
+  if (m_buffer.size() >= FlushInterval) {
+    flush();
+  }
 
-  // Periodically flush to disk (to avoid cases where the destructor is not called)
-  m_samples_since_write += len;
-  if (m_samples_since_write >= WriteInterval) {
-    writeWAVData();
-    m_samples_since_write = 0;
+  m_samples_since_header += len;
+  if (m_wav && m_samples_since_header >= HeaderInterval) {
+    writeWAVHeader();
+    m_samples_since_header = 0;
   }
 }
 
-void SoundExporter::writeWAVData() {
-  // Taken from http://stackoverflow.com/questions/22226872/two-problems-when-writing-to-wav-c
-  // Open file stream
-  std::ofstream stream(m_filename.c_str(), std::ios::binary);
+void SoundExporter::flush() {
+  m_stream.write((const char*)m_buffer.data(), m_buffer.size() * sizeof(SampleType));
+  m_samples_written += m_buffer.size();
+  m_buffer.clear();
+}
 
-  // Cast size into a 32-bit integer
-  int bufSize = m_data.size();
+void SoundExporter::writeWAVHeader() {
+  // Taken from http://stackoverflow.com/questions/22226872/two-problems-when-writing-to-wav-c
+  // Only the samples already in the file are counted
+  int bufSize = m_samples_written * sizeof(SampleType);
+  std::streampos end = m_stream.tellp();
+  m_stream.seekp(0);
 
   // Header
-  stream.write("RIFF", 4);          // sGroupID (RIFF = Resource Interchange File Format)
-  write<int>(stream, 36 + bufSize); // dwFileLength
-  stream.write("WAVE", 4);          // sRiffType
+  m_stream.write("RIFF", 4);          // sGroupID (RIFF = Resource Interchange File Format)
+  write<int>(m_stream, 36 + bufSize); // dwFileLength
+  m_stream.write("WAVE", 4);          // sRiffType
 
   // Format chunk
-  stream.write("fmt ", 4);          // sGroupID (fmt = format)
-  write<int>(stream, 16);           // Chunk size (of Format Chunk)
-  write<short>(stream, 1);          // Format (1 = PCM)
-  write<short>(stream, m_channels); // Channels
-  write<int>(stream, SampleRate);   // Sample Rate
-  write<int>(stream, SampleRate * m_channels * sizeof(SampleType));  // Byterate
-  write<short>(stream, m_channels * sizeof(SampleType));             // Frame size aka Block align
-  write<short>(stream, 8 * sizeof(SampleType));                      // Bits per sample
+  m_stream.write("fmt ", 4);          // sGroupID (fmt = format)
+  write<int>(m_stream, 16);           // Chunk size (of Format Chunk)
+  write<short>(m_stream, 1);          // Format (1 = PCM)
+  write<short>(m_stream, m_channels); // Channels
+  write<int>(m_stream, SampleRate);   // Sample Rate
+  write<int>(m_stream, SampleRate * m_channels * sizeof(SampleType));  // Byterate
+  write<short>(m_stream, m_channels * sizeof(SampleType));             // Frame size aka Block align
+  write<short>(m_stream, 8 * sizeof(SampleType));                      // Bits per sample
 
   // Data chunk
-  stream.write("data", 4);                         // sGroupID (data)
-  stream.write((const char*)&bufSize, 4);          // Chunk size (of Data, and thus of bufferSize)
-  stream.write((const char*)&m_data[0], bufSize);  // The samples DATA!!!
+  m_stream.write("data", 4);                 // sGroupID (data)
+  write<int>(m_stream, bufSize);             // Chunk size (of Data, and thus of bufferSize)
+
+  if (end > m_stream.tellp()) {
+    m_stream.seekp(end);
+  }
+  m_stream.flush();
 }
 
 }  // namespace sound
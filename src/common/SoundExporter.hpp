@@ -11,7 +11,11 @@
  * *****************************************************************************
  *  SoundExporter.hpp
  *
- *  A class for writing Atari 2600 sound to a WAV file.
+ *  A class for writing Atari 2600 sound to a WAV file, or to a headerless
+ *  file of 8-bit samples if the filename ends in ".raw".
+ *
+ *  Samples are buffered and appended to the file; the WAV header's sizes
+ *  are patched in place now and then and when the exporter is destroyed.
  *
  *  Parts of this code were taken from
  *
@@ -22,7 +26,9 @@
 #ifndef __SOUND_EXPORTER_HPP__
 #define __SOUND_EXPORTER_HPP__
 
+#include <cstdint>
 #include <fstream>
+#include <string>
 #include <vector>
 
 
@@ -39,28 +45,39 @@ class SoundExporter {
 
   using SampleType = uint8_t;
 
-  /** Create a new sound exporter which, on program termination, will write out a wav file. */
+  /** Create a new sound exporter, writing the header straight away. */
   SoundExporter(const std::string& filename, int channels);
+
+  /** Writes out the buffered samples and the final header. */
   ~SoundExporter();
 
   /** Adds a buffer of samples. */
   void addSamples(SampleType* s, int len);
 
  private:
-  /** Writes the data to disk. */
-  void writeWAVData();
+  /** Writes the header, with the sizes for the samples written so far. */
+  void writeWAVHeader();
+
+  /** Appends the buffered samples to the file. */
+  void flush();
 
-  /** The file to save our audio to. */
-  std::string m_filename;
+  /** The file we save our audio to. */
+  std::ofstream m_stream;
+
+  /** Whether the file has a WAV header. */
+  bool m_wav;
 
   /** Number of channels. */
   int m_channels;
 
-  /** The sound data. */
-  std::vector<SampleType> m_data;
+  /** Samples not yet written to the file. */
+  std::vector<SampleType> m_buffer;
+
+  /** Number of samples written to the file. */
+  size_t m_samples_written;
 
-  /** Keep track of how many samples have been written since the last write to disk */
-  size_t m_samples_since_write;
+  /** Keep track of how many samples have been written since the header was updated */
+  size_t m_samples_since_header;
 };
 
 }  // namespace sound
@@ -0,0 +1,119 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ThreadPool.cpp
+ *
+ *  A fixed set of worker threads that share out the indices of a loop.
+ **************************************************************************** */
+
+#include "common/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace ale {
+
+ThreadPool::ThreadPool(size_t threads)
+    : m_generation(0),
+      m_running(0),
+      m_stop(false),
+      m_task(nullptr),
+      m_count(0),
+      m_next(0) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t t = 1; t < threads; t++) {
+    m_workers.emplace_back(&ThreadPool::work, this, t);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all();
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::parallelFor(size_t count, const Task& task) {
+  if (count == 0) return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_running = m_workers.size();
+    m_generation++;
+  }
+  m_start.notify_all();
+
+  runTasks(0);
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this] { return m_running == 0; });
+    m_task = nullptr;
+  }
+
+  if (m_error) {
+    std::exception_ptr error;
+    error.swap(m_error);
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::run(size_t count, size_t threads, const Task& task) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  ThreadPool pool(std::max<size_t>(1, std::min(threads, count)));
+  pool.parallelFor(count, task);
+}
+
+void ThreadPool::work(size_t thread) {
+  size_t generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start.wait(lock, [&] { return m_stop || m_generation != generation; });
+      if (m_stop) return;
+      generation = m_generation;
+    }
+
+    runTasks(thread);
+
+    bool last;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      last = --m_running == 0;
+    }
+    if (last) m_finished.notify_one();
+  }
+}
+
+void ThreadPool::runTasks(size_t thread) {
+  // Threads pull the next index off a shared counter so that a few slow
+  // iterations don't hold up the rest
+  for (size_t i = m_next++; i < m_count; i = m_next++) {
+    try {
+      (*m_task)(thread, i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_error_mutex);
+      if (!m_error) m_error = std::current_exception();
+      m_next = m_count;
+    }
+  }
+}
+
+}  // namespace ale
@@ -0,0 +1,87 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ThreadPool.hpp
+ *
+ *  A fixed set of worker threads that share out the indices of a loop.
+ **************************************************************************** */
+
+#ifndef __THREAD_POOL_HPP__
+#define __THREAD_POOL_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ale {
+
+class ThreadPool {
+ public:
+  /** Called with the number of the thread running it, below size(), and
+   *  the index of the loop iteration. */
+  using Task = std::function<void(size_t thread, size_t index)>;
+
+  /** Starts threads - 1 workers (0 uses all hardware threads); the thread
+   *  calling parallelFor is thread 0. */
+  explicit ThreadPool(size_t threads = 0);
+
+  /** Stops and joins the workers. */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /** Number of threads running tasks, the caller included. */
+  size_t size() const { return m_workers.size() + 1; }
+
+  /** Calls task for each index below count, spread over the threads, and
+   *  returns once all are done. After an exception no more indices are
+   *  handed out and the first exception is rethrown. Only one call may
+   *  run at a time, and tasks mustn't call it again. */
+  void parallelFor(size_t count, const Task& task);
+
+  /** Runs a loop on a pool of at most `threads` threads (0 uses all
+   *  hardware threads) that lives for the duration of the call. */
+  static void run(size_t count, size_t threads, const Task& task);
+
+ private:
+  /** The loop of worker thread `thread`. */
+  void work(size_t thread);
+
+  /** Takes indices of the current loop until there are none left. */
+  void runTasks(size_t thread);
+
+  std::vector<std::thread> m_workers;
+
+  // Guarded by m_mutex
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_finished;
+  size_t m_generation;  // Number of loops started
+  size_t m_running;     // Workers still in the current loop
+  bool m_stop;
+
+  // Set before a loop starts, read by the workers running it
+  const Task* m_task;
+  size_t m_count;
+  std::atomic<size_t> m_next;
+
+  std::mutex m_error_mutex;
+  std::exception_ptr m_error;
+};
+
+}  // namespace ale
+
+#endif  // __THREAD_POOL_HPP__
@@ -0,0 +1,224 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  Trace.cpp
+ *
+ *  Per-thread event rings and their Chrome trace JSON output.
+ **************************************************************************** */
+
+#include "common/Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ale {
+
+namespace {
+
+struct Event {
+  const char* name;
+  uint32_t id;
+  uint64_t start;
+  uint64_t end;
+};
+
+// A slot of the ring. Its fields are relaxed atomics so a dumping thread
+// may read a slot while the owner overwrites it; the dump then discards it.
+struct EventSlot {
+  std::atomic<const char*> name{nullptr};
+  std::atomic<uint32_t> id{0};
+  std::atomic<uint64_t> start{0};
+  std::atomic<uint64_t> end{0};
+};
+
+// Written only by its owning thread, like a seqlock: the release fence
+// before an event is written means a dumping thread that sees any of it also
+// sees the head of the event before, and the head is published with release
+// semantics after each event so a dumping thread sees complete events.
+struct ThreadBuffer {
+  ThreadBuffer(size_t capacity, uint32_t tid)
+      : events(capacity), tid(tid), head(0), first(0), retired(false) {}
+
+  std::vector<EventSlot> events;
+  uint32_t tid;
+  std::atomic<uint64_t> head;   // Number of events ever recorded
+  std::atomic<uint64_t> first;  // Number of events dropped by clear()
+  bool retired;                 // Owning thread exited; guarded by the registry
+};
+
+// Owns the buffers of every thread that recorded an event, so they can be
+// dumped after the thread exits. Only touched when a thread records its
+// first event or exits, and by clear() and dump().
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::atomic<size_t> capacity{1 << 16};
+};
+
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+
+std::chrono::steady_clock::time_point epoch() {
+  static const std::chrono::steady_clock::time_point epoch =
+      std::chrono::steady_clock::now();
+  return epoch;
+}
+
+// Hands the thread's buffer back to the registry when the thread exits, so
+// a thread started later takes it over instead of allocating another.
+struct BufferOwner {
+  std::shared_ptr<ThreadBuffer> buffer;
+
+  ~BufferOwner() {
+    if (buffer) {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      buffer->retired = true;
+    }
+  }
+};
+
+ThreadBuffer& threadBuffer() {
+  thread_local BufferOwner owner;
+  if (!owner.buffer) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const size_t capacity = r.capacity.load();
+    for (const auto& buffer : r.buffers) {
+      if (buffer->retired && buffer->events.size() == capacity) {
+        buffer->retired = false;
+        owner.buffer = buffer;
+        return *buffer;
+      }
+    }
+
+    // The lowest tid no buffer uses, so tids stay below the number of
+    // threads recording at once
+    std::vector<bool> used(r.buffers.size() + 1, false);
+    for (const auto& buffer : r.buffers) {
+      if (buffer->tid < used.size()) used[buffer->tid] = true;
+    }
+    uint32_t tid = std::find(used.begin(), used.end(), false) - used.begin();
+    owner.buffer = std::make_shared<ThreadBuffer>(capacity, tid);
+    r.buffers.push_back(owner.buffer);
+  }
+  return *owner.buffer;
+}
+
+}  // namespace
+
+std::atomic<bool> Trace::s_enabled(false);
+
+void Trace::enable(size_t events_per_thread) {
+  registry().capacity.store(std::max<size_t>(events_per_thread, 1));
+  epoch();
+  s_enabled.store(true);
+}
+
+void Trace::disable() { s_enabled.store(false); }
+
+void Trace::clear() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  // Buffers of exited threads hold nothing else, so they are freed
+  r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end(),
+                                 [](const std::shared_ptr<ThreadBuffer>& b) {
+                                   return b->retired;
+                                 }),
+                  r.buffers.end());
+  for (const auto& buffer : r.buffers) {
+    buffer->first.store(buffer->head.load(std::memory_order_acquire));
+  }
+}
+
+uint64_t Trace::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch()).count();
+}
+
+void Trace::record(const char* name, uint32_t id, uint64_t start,
+                   uint64_t end) {
+  ThreadBuffer& buffer = threadBuffer();
+  uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  EventSlot& slot = buffer.events[head % buffer.events.size()];
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.id.store(id, std::memory_order_relaxed);
+  slot.start.store(start, std::memory_order_relaxed);
+  slot.end.store(end, std::memory_order_relaxed);
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Trace::dump(std::ostream& out) {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    buffers = r.buffers;
+  }
+
+  char line[256];
+  bool first_line = true;
+  auto emit = [&]() {
+    out << (first_line ? "\n" : ",\n") << line;
+    first_line = false;
+  };
+
+  out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+  std::vector<Event> events;
+  for (const auto& buffer : buffers) {
+    const uint64_t capacity = buffer->events.size();
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t begin = std::max(buffer->first.load(),
+                              head > capacity ? head - capacity : 0);
+
+    events.clear();
+    for (uint64_t i = begin; i < head; i++) {
+      const EventSlot& slot = buffer->events[i % capacity];
+      events.push_back({slot.name.load(std::memory_order_relaxed),
+                        slot.id.load(std::memory_order_relaxed),
+                        slot.start.load(std::memory_order_relaxed),
+                        slot.end.load(std::memory_order_relaxed)});
+    }
+
+    // Anything the owning thread may have overwritten while we copied is
+    // discarded, including the slot of event now_head, which it may be
+    // writing before publishing now_head + 1
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t now_head = buffer->head.load(std::memory_order_relaxed);
+    uint64_t valid = now_head + 1 > capacity ? now_head + 1 - capacity : 0;
+
+    std::snprintf(line, sizeof(line),
+                  "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                  "\"tid\": %u, \"args\": {\"name\": \"ale-%u\"}}",
+                  buffer->tid, buffer->tid);
+    emit();
+
+    for (uint64_t i = std::max(begin, valid); i < head; i++) {
+      const Event& e = events[i - begin];
+      std::snprintf(line, sizeof(line),
+                    "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, "
+                    "\"tid\": %u, \"ts\": %.3f, \"dur\": %.3f, "
+                    "\"args\": {\"env\": %u}}",
+                    e.name, buffer->tid, e.start / 1000.0,
+                    (e.end - e.start) / 1000.0, e.id);
+      emit();
+    }
+  }
+  out << "\n]}\n";
+}
+
+}  // namespace ale
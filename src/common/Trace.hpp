@@ -0,0 +1,88 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  Trace.hpp
+ *
+ *  Timeline tracing of environment calls, written out in the Chrome trace
+ *  event format (chrome://tracing, https://ui.perfetto.dev).
+ *
+ *  Every thread records into its own fixed-size ring buffer, so recording
+ *  an event takes no locks and, once the thread's buffer exists, doesn't
+ *  allocate. When tracing is disabled a scope costs one relaxed load.
+ *  The buffer of a thread that exits is kept for dumping and taken over,
+ *  with its tid, by the next thread to record, so the buffers never
+ *  outnumber the threads recording at once.
+ **************************************************************************** */
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace ale {
+
+class Trace {
+ public:
+  /* Starts recording. Threads that record their first event from now on
+   * keep the last `events_per_thread` events. */
+  static void enable(size_t events_per_thread = 1 << 16);
+
+  /* Stops recording; events recorded so far are kept until clear(). */
+  static void disable();
+
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  /* Drops every event recorded so far, freeing the buffers of threads that
+   * have exited. */
+  static void clear();
+
+  /* Writes the recorded events of every thread as Chrome trace JSON. Events
+   * that threads overwrite while the dump is running, or may be about to,
+   * are left out. */
+  static void dump(std::ostream& out);
+
+  /* Nanoseconds on the trace clock. */
+  static uint64_t now();
+
+  /* Records a complete event. `name` must be a string literal (or outlive
+   * the trace); `id` tells apart environments that share a thread. */
+  static void record(const char* name, uint32_t id, uint64_t start,
+                     uint64_t end);
+
+ private:
+  static std::atomic<bool> s_enabled;
+};
+
+/* Records an event spanning its own lifetime, if tracing is enabled. */
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name, uint32_t id = 0)
+      : m_name(Trace::enabled() ? name : nullptr),
+        m_id(id),
+        m_start(m_name ? Trace::now() : 0) {}
+
+  ~TraceScope() {
+    if (m_name) Trace::record(m_name, m_id, m_start, Trace::now());
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* m_name;
+  uint32_t m_id;
+  uint64_t m_start;
+};
+
+}  // namespace ale
+
+#endif  // TRACE_HPP
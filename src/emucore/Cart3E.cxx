@@ -207,6 +207,7 @@ bool Cartridge3E::load(Deserializer& in)
 void Cartridge3E::bank(uint16_t bank)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   if(bank < 256)
   {
@@ -182,6 +182,7 @@ bool Cartridge3F::load(Deserializer& in)
 void Cartridge3F::bank(uint16_t bank)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Make sure the bank they're asking for is reasonable
   if((uint32_t)bank * 2048 < mySize)
@@ -566,6 +566,7 @@ bool CartridgeAR::load(Deserializer& in)
 void CartridgeAR::bank(uint16_t bank)
 {
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   bankConfiguration(bank);
 }
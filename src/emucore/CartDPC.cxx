@@ -557,6 +557,7 @@ bool CartridgeDPC::load(Deserializer& in)
 void CartridgeDPC::bank(uint16_t bank)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Remember what bank we're in
   myCurrentBank = bank;
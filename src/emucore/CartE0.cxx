@@ -142,6 +142,8 @@ void CartridgeE0::poke(uint16_t address, uint8_t)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE0::segmentZero(uint16_t slice)
 { 
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
+
   // Remember the new slice
   myCurrentSlice[0] = slice;
   uint16_t offset = slice << 10;
@@ -162,6 +164,8 @@ void CartridgeE0::segmentZero(uint16_t slice)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE0::segmentOne(uint16_t slice)
 { 
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
+
   // Remember the new slice
   myCurrentSlice[1] = slice;
   uint16_t offset = slice << 10;
@@ -182,6 +186,8 @@ void CartridgeE0::segmentOne(uint16_t slice)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeE0::segmentTwo(uint16_t slice)
 { 
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
+
   // Remember the new slice
   myCurrentSlice[2] = slice;
   uint16_t offset = slice << 10;
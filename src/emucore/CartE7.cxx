@@ -248,6 +248,7 @@ bool CartridgeE7::load(Deserializer& in)
 void CartridgeE7::bank(uint16_t slice)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Remember what bank we're in
   myCurrentSlice[0] = slice;
@@ -204,6 +204,7 @@ bool CartridgeF6::load(Deserializer& in)
 void CartridgeF6::bank(uint16_t bank)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Remember what bank we're in
   myCurrentBank = bank;
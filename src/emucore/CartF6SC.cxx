@@ -244,6 +244,7 @@ bool CartridgeF6SC::load(Deserializer& in)
 void CartridgeF6SC::bank(uint16_t bank)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Remember what bank we're in
   myCurrentBank = bank;
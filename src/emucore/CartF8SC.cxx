@@ -226,6 +226,7 @@ bool CartridgeF8SC::load(Deserializer& in)
 void CartridgeF8SC::bank(uint16_t bank)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Remember what bank we're in
   myCurrentBank = bank;
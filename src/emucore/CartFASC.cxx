@@ -232,6 +232,7 @@ bool CartridgeFASC::load(Deserializer& in)
 void CartridgeFASC::bank(uint16_t bank)
 {
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Remember what bank we're in
   myCurrentBank = bank;
@@ -185,6 +185,7 @@ bool CartridgeMB::load(Deserializer& in)
 void CartridgeMB::bank(uint16_t bank)
 {
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   myCurrentBank = (bank - 1);
   incbank();
@@ -198,6 +198,7 @@ bool CartridgeUA::load(Deserializer& in)
 void CartridgeUA::bank(uint16_t bank)
 { 
   if(bankLocked) return;
+  ALE_PERF_COUNT(mySystem->perfStats(), PERF_BANK_SWITCHES, 1);
 
   // Remember what bank we're in
   myCurrentBank = bank;
@@ -109,7 +109,7 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   myControllers[1]->setSystem(mySystem);
 
   M6502* m6502;
-  if(myOSystem->settings().getString("cpu") == "low") {
+  if(myOSystem->settings().getString(Setting_Cpu) == "low") {
     m6502 = new M6502Low(1);
   }
   else {
@@ -129,14 +129,10 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   // Remember what my media source is
   myMediaSource = tia;
 
-  // Query some info about this console
-  std::ostringstream buf;
-  buf << "  Cart Name: " << myProperties.get(Cartridge_Name) << std::endl
-      << "  Cart MD5:  " << myProperties.get(Cartridge_MD5) << std::endl;
+  myCartridge = cart;
 
   // Auto-detect NTSC/PAL mode if it's requested
   myDisplayFormat = myProperties.get(Display_Format);
-  buf << "  Display Format:  " << myDisplayFormat;
   if(myDisplayFormat == "AUTO-DETECT" ||
      myOSystem->settings().getBool("rominfo"))
   {
@@ -155,10 +151,7 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
     }
 
     myDisplayFormat = (palCount >= 15) ? "PAL" : "NTSC";
-    if(myProperties.get(Display_Format) == "AUTO-DETECT")
-      buf << " ==> " << myDisplayFormat;
   }
-  buf << std::endl << cart->about();
 
   // Make sure height is set properly for PAL ROM
   if((myDisplayFormat == "PAL" || myDisplayFormat == "SECAM") &&
@@ -167,8 +160,6 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
 
   // Reset, the system to its power-on state
   mySystem->reset();
-
-  myAboutString = buf.str();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -207,6 +198,20 @@ uint32_t Console::getFrameRate() const
   return framerate;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::string Console::about() const
+{
+  std::ostringstream buf;
+  buf << "  Cart Name: " << myProperties.get(Cartridge_Name) << std::endl
+      << "  Cart MD5:  " << myProperties.get(Cartridge_MD5) << std::endl
+      << "  Display Format:  " << myProperties.get(Display_Format);
+  if(myProperties.get(Display_Format) == "AUTO-DETECT")
+    buf << " ==> " << myDisplayFormat;
+  buf << std::endl << myCartridge->about();
+
+  return buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Console::Console(const Console& console)
   : myOSystem(console.myOSystem)
@@ -126,9 +126,10 @@ class Console
     void setProperties(const Properties& props);
 
     /**
-      Query some information about this console.
+      Query some information about this console.  The description is
+      built on each call, so only ask for it when it will be shown.
     */
-    const std::string& about() const { return myAboutString; }
+    std::string about() const;
 
   public:
     /**
@@ -176,8 +177,8 @@ class Console
     // The currently defined display format (NTSC/PAL/PAL60)
     std::string myDisplayFormat;
 
-    // Contains info about this console in string format
-    std::string myAboutString;
+    // The cartridge, owned by mySystem
+    const Cartridge* myCartridge;
 
 };
 
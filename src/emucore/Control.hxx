@@ -99,6 +99,11 @@ class Controller
     */
     Type type();
 
+    /**
+      Returns the jack this controller is plugged into.
+    */
+    Jack jack() const { return myJack; }
+
     /**
       Inform this controller about the current System.
     */
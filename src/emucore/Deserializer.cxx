@@ -17,39 +17,34 @@
 //============================================================================
 
 #include "emucore/Deserializer.hxx"
-#include <sstream>
 
 namespace ale {
 namespace stella {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Deserializer::Deserializer(const std::string stream_str):
-myStream(stream_str) {
-    
+Deserializer::Deserializer(std::string_view stream_str)
+  : myData(stream_str),
+    myPosition(0)
+{
 }
 
 
-
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Deserializer::close(void)
 {
-  myStream.clear();
 }
 
 
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Deserializer::getInt(void)
 {
-  if(myStream.eof())
+  if(myData.size() - myPosition < 4)
     throw "Deserializer: end of file";
 
   int val = 0;
-  unsigned char buf[4];
-  myStream.read((char*)buf, 4);
   for(int i = 0; i < 4; ++i)
-    val += (int)(buf[i]) << (i<<3);
+    val += (int)(unsigned char)myData[myPosition + i] << (i<<3);
+  myPosition += 4;
 
   return val;
 }
@@ -57,14 +52,19 @@ int Deserializer::getInt(void)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 std::string Deserializer::getString(void)
 {
-  int len = getInt();
-  std::string str;
-  str.resize((std::string::size_type)len);
-  myStream.read(&str[0], (std::streamsize)len);
+  return std::string(getStringView());
+}
 
-  if(myStream.bad())
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::string_view Deserializer::getStringView(void)
+{
+  int len = getInt();
+  if(len < 0 || (size_t)len > myData.size() - myPosition)
     throw "Deserializer: file read failed";
 
+  std::string_view str = myData.substr(myPosition, len);
+  myPosition += len;
+
   return str;
 }
 
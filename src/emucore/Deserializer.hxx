@@ -19,7 +19,9 @@
 #ifndef DESERIALIZER_HXX
 #define DESERIALIZER_HXX
 
-#include <sstream>
+#include <cstddef>
+#include <string>
+#include <string_view>
 
 namespace ale {
 namespace stella {
@@ -36,16 +38,16 @@ namespace stella {
  @version $Id: Deserializer.hxx,v 1.11 2007/01/01 18:04:47 stephena Exp $
  
  Revised for ALE on Sep 20, 2009
- The new version uses a stringstream (not a file stream)
- 
- TODO: don't copy the whole streams. 
+ The new version reads from a string (not a file stream) in place, without
+ copying it.
  */
 class Deserializer {
     public:
         /**
-         Creates a new Deserializer device.
+         Creates a new Deserializer device reading the given string, which
+         must outlive the Deserializer.
          */
-        Deserializer(const std::string stream_str);
+        Deserializer(std::string_view stream_str);
         
         void close(void);
 
@@ -62,6 +64,13 @@ class Deserializer {
          @result The string which has been read from the stream.
          */
         std::string getString(void);
+
+        /**
+         Reads a string from the current input stream without copying it.
+
+         @result The string, which points into the data being deserialized.
+         */
+        std::string_view getStringView(void);
         
         /**
          Reads a boolean value from the current input stream.
@@ -72,8 +81,9 @@ class Deserializer {
         
         bool isOpen(void) {return true;}
     private:
-        // The stream to get the deserialized data from.
-        std::stringstream myStream;
+        // The data to get the deserialized values from, and the read position
+        std::string_view myData;
+        size_t myPosition;
         
         enum {
             TruePattern  = 0xfab1fab2,
@@ -100,6 +100,19 @@ void M6502::stop()
   myExecutionStatus |= StopExecutionBit;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::getRegisters(uint8_t registers[8]) const
+{
+  registers[0] = A;
+  registers[1] = X;
+  registers[2] = Y;
+  registers[3] = SP;
+  registers[4] = IR;
+  registers[5] = PS();
+  registers[6] = PC & 0xff;
+  registers[7] = PC >> 8;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::AddressingMode M6502::addressingMode(uint8_t opcode) const
 {
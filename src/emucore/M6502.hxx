@@ -165,6 +165,14 @@ class M6502
     */
     uint16_t getPC() const { return PC; }
 
+    /**
+      Get the register file in the same form for every CPU implementation:
+      A, X, Y, SP, IR, the processor status, then PC low and high.
+
+      @param registers Filled with the eight register bytes
+    */
+    void getRegisters(uint8_t registers[8]) const;
+
     /**
       Answer true iff the last memory access was a read.
 
@@ -89,6 +89,7 @@ bool M6502High::execute(uint32_t number)
 
       // Fetch instruction at the program counter
       IR = peek(PC++);
+      ALE_PERF_COUNT(mySystem->perfStats(), PERF_CPU_INSTRUCTIONS, 1);
 
 #ifdef DEBUG
       debugStream << "IR=" << hex << setw(2) << (int)IR << " ";
@@ -117,6 +117,13 @@ class M6532 : public Device
     */
     virtual void poke(uint16_t address, uint8_t value);
 
+    /**
+      Answer the 128 bytes of RAM, mapped at $80-$FF
+
+      @return The RAM
+    */
+    const uint8_t* ram() const { return myRAM; }
+
   private:
     // Reference to the console
     const Console& myConsole;
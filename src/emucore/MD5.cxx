@@ -348,5 +348,33 @@ std::string MD5(const uint8_t* buffer, uint32_t length)
   return result;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool parseMD5Key(const char* digest, std::size_t length, MD5Key& key)
+{
+  if(length != 32)
+    return false;
+
+  uint64_t words[2] = { 0, 0 };
+  for(int t = 0; t < 32; ++t)
+  {
+    char c = digest[t];
+    uint64_t nibble;
+    if(c >= '0' && c <= '9')
+      nibble = c - '0';
+    else if(c >= 'a' && c <= 'f')
+      nibble = c - 'a' + 10;
+    else if(c >= 'A' && c <= 'F')
+      nibble = c - 'A' + 10;
+    else
+      return false;
+
+    words[t / 16] = (words[t / 16] << 4) | nibble;
+  }
+
+  key.hi = words[0];
+  key.lo = words[1];
+  return true;
+}
+
 }  // namespace stella
 }  // namespace ale
@@ -19,6 +19,7 @@
 #ifndef MD5_HXX
 #define MD5_HXX
 
+#include <cstdint>
 #include <string>
 
 namespace ale {
@@ -34,6 +35,35 @@ namespace stella {
 */
 std::string MD5(const uint8_t* buffer, uint32_t length);
 
+/**
+  A 128-bit MD5 digest packed into two integers, used as the key for
+  ROM lookups instead of comparing 32-character strings.
+*/
+struct MD5Key
+{
+  uint64_t hi;
+  uint64_t lo;
+
+  bool operator<(const MD5Key& other) const
+    { return hi < other.hi || (hi == other.hi && lo < other.lo); }
+  bool operator==(const MD5Key& other) const
+    { return hi == other.hi && lo == other.lo; }
+  bool operator!=(const MD5Key& other) const
+    { return !(*this == other); }
+};
+
+/**
+  Parse a digest of 32 hexadecimal digits (either case) into a key.
+
+  @param digest The hexadecimal digest, need not be null-terminated
+  @param length The number of characters in digest
+  @param key    The parsed key
+  @return true if digest held 32 valid hexadecimal digits
+*/
+bool parseMD5Key(const char* digest, std::size_t length, MD5Key& key);
+inline bool parseMD5Key(const std::string& digest, MD5Key& key)
+  { return parseMD5Key(digest.data(), digest.size(), key); }
+
 }  // namespace stella
 }  // namespace ale
 
@@ -116,18 +116,30 @@ void OSystem::createSound()
   }
   mySound = NULL;
 
+  // Samples are only generated per frame when someone will read them
+  bool capture = mySettings->getBool(Setting_SoundObs) ||
+                 !mySettings->getString(Setting_RecordSoundFilename).empty();
+
 #ifdef SDL_SUPPORT
   // If requested (& supported), enable sound
-  if (mySettings->getBool("sound") == true) {
+  if (mySettings->getBool(Setting_Sound) == true) {
       mySound = new SoundSDL(mySettings);
       mySound->initialize();
   }
+  else if (capture) {
+      mySound = new SoundCapture(mySettings);
+  }
   else {
       mySound = new SoundNull(mySettings);
   }
 #else
   mySettings->setBool("sound", false);
-  mySound = new SoundNull(mySettings);
+  if (capture) {
+      mySound = new SoundCapture(mySettings);
+  }
+  else {
+      mySound = new SoundNull(mySettings);
+  }
 #endif
 }
 
@@ -164,9 +176,12 @@ bool OSystem::createConsole(const fs::path& romfile)
       // Create an instance of the 2600 game console
       myConsole = new Console(this, cart, props);
 
-      ale::Logger::Info << "Game console created:" << std::endl
-            << "  ROM file:  " << myRomFile << std::endl
-            << myConsole->about() << std::endl;
+      if(ale::Logger::enabled(ale::Logger::Info))
+      {
+        ale::Logger::Info << "Game console created:" << std::endl
+              << "  ROM file:  " << myRomFile << std::endl
+              << myConsole->about() << std::endl;
+      }
 
       retval = true;
     }
@@ -187,7 +202,7 @@ bool OSystem::createConsole(const fs::path& romfile)
 
   myScreen = new Screen(this);
 
-  if (mySettings->getBool("display_screen", true)) {
+  if (mySettings->getBool(Setting_DisplayScreen)) {
 #ifdef SDL_SUPPORT
     myScreen = new ale::ScreenSDL(this);
 #else
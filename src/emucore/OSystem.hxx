@@ -32,6 +32,7 @@ class PropertiesSet;
 #include "emucore/Sound.hxx"
 #include "emucore/Screen.hxx"
 #include "common/SoundNull.hxx"
+#include "common/SoundCapture.hxx"
 #include "emucore/Settings.hxx"
 #include "emucore/Console.hxx"
 #include "emucore/Event.hxx"  //ALE 
@@ -105,6 +106,13 @@ class OSystem
     */
     inline Settings& settings() const { return *mySettings; }
 
+    /**
+      Get the set of game properties
+
+      @return The properties set object
+    */
+    inline PropertiesSet& propSet() const { return *myPropSet; }
+
     /**
       Get the console of the system.
 
@@ -112,6 +120,13 @@ class OSystem
     */
     inline Console& console(void) const { return *myConsole; }
 
+    /**
+      Answers whether a console has been created for a ROM.
+
+      @return True if a console exists
+    */
+    inline bool hasConsole() const { return myConsole != NULL; }
+
     /**
       Set the framerate for the video system.  It's placed in this class since
       the mainLoop() method is defined here.
@@ -26,42 +26,26 @@ namespace stella {
 Paddles::Paddles(Jack jack, const Event& event, bool swap)
   : Controller(jack, event, Controller::Paddles)
 {
-  // Swap the paddle events, from paddle 0 <=> 1 and paddle 2 <=> 3
+  // Swap the paddles, from paddle 0 <=> 1 and paddle 2 <=> 3
   if(!swap)
   {
-    // Pin Three
-    myPinEvents[0][0] = Event::PaddleOneFire;
-    myPinEvents[0][1] = Event::PaddleThreeFire;
-
-    // Pin Four
-    myPinEvents[1][0] = Event::PaddleZeroFire;
-    myPinEvents[1][1] = Event::PaddleTwoFire;
-
-    // Pin Five
-    myPinEvents[2][0] = Event::PaddleOneResistance;
-    myPinEvents[2][1] = Event::PaddleThreeResistance;
-
-    // Pin Nine
-    myPinEvents[3][0] = Event::PaddleZeroResistance;
-    myPinEvents[3][1] = Event::PaddleTwoResistance;
+    myPinPaddles[0] = 1;  // Pin Three, fire of paddle one (three)
+    myPinPaddles[1] = 0;  // Pin Four, fire of paddle zero (two)
+    myPinPaddles[2] = 1;  // Pin Five, resistance of paddle one (three)
+    myPinPaddles[3] = 0;  // Pin Nine, resistance of paddle zero (two)
   }
   else
   {
-    // Pin Three (swapped)
-    myPinEvents[0][0] = Event::PaddleZeroFire;
-    myPinEvents[0][1] = Event::PaddleTwoFire;
-
-    // Pin Four (swapped)
-    myPinEvents[1][0] = Event::PaddleOneFire;
-    myPinEvents[1][1] = Event::PaddleThreeFire;
-
-    // Pin Five (swapped)
-    myPinEvents[2][0] = Event::PaddleZeroResistance;
-    myPinEvents[2][1] = Event::PaddleTwoResistance;
+    myPinPaddles[0] = 0;
+    myPinPaddles[1] = 1;
+    myPinPaddles[2] = 0;
+    myPinPaddles[3] = 1;
+  }
 
-    // Pin Nine (swapped)
-    myPinEvents[3][0] = Event::PaddleOneResistance;
-    myPinEvents[3][1] = Event::PaddleThreeResistance;
+  for(int i = 0; i < 2; ++i)
+  {
+    myResistance[i] = 0;
+    myFire[i] = false;
   }
 }
 
@@ -76,12 +60,10 @@ bool Paddles::read(DigitalPin pin)
   switch(pin)
   {
     case Three:
-      return (myJack == Left) ? (myEvent.get(myPinEvents[0][0]) == 0) : 
-          (myEvent.get(myPinEvents[0][1]) == 0);
+      return !myFire[myPinPaddles[0]];
 
     case Four:
-      return (myJack == Left) ? (myEvent.get(myPinEvents[1][0]) == 0) : 
-          (myEvent.get(myPinEvents[1][1]) == 0);
+      return !myFire[myPinPaddles[1]];
 
     default:
       // Other pins are not connected (floating high)
@@ -95,12 +77,10 @@ int Paddles::read(AnalogPin pin)
   switch(pin)
   {
     case Five:
-      return (myJack == Left) ? myEvent.get(myPinEvents[2][0]) : 
-          myEvent.get(myPinEvents[2][1]);
+      return myResistance[myPinPaddles[2]];
 
     case Nine:
-      return (myJack == Left) ? myEvent.get(myPinEvents[3][0]) : 
-          myEvent.get(myPinEvents[3][1]);
+      return myResistance[myPinPaddles[3]];
 
     default:
       return maximumResistance;
@@ -76,10 +76,36 @@ class Paddles : public Controller
     */
     virtual void write(DigitalPin pin, bool value);
 
+    /**
+      Set the resistance of one of the two paddles plugged into this jack.
+      The paddles hold their state themselves rather than in the event
+      object, since the CPU reads it on every access to INPT0-3.
+
+      @param paddle     The paddle, 0 (paddle zero or two) or 1 (one or three)
+      @param resistance The resistance in ohms
+    */
+    void setResistance(int paddle, int resistance)
+    {
+      myResistance[paddle] = resistance;
+    }
+
+    /**
+      Press or release the fire button of one of the two paddles plugged
+      into this jack.
+
+      @param paddle  The paddle, 0 (paddle zero or two) or 1 (one or three)
+      @param pressed Whether the button is pressed
+    */
+    void setFire(int paddle, bool pressed) { myFire[paddle] = pressed; }
+
   private:
-    // Used to implement paddle swapping efficiently, and eliminate
-    // testing at runtime
-    Event::Type myPinEvents[4][2];
+    // The paddle read by pins Three, Four, Five and Nine, which implements
+    // paddle swapping without testing at runtime
+    int myPinPaddles[4];
+
+    // The state of each paddle
+    int myResistance[2];
+    bool myFire[2];
 };
 
 }  // namespace stella
@@ -20,14 +20,31 @@
 #include <sstream>
 #include <cstring>
 #include <iostream>
+#include <algorithm>
+#include <mutex>
 
 #include "emucore/DefProps.hxx"
+#include "emucore/MD5.hxx"
 #include "emucore/Props.hxx"
 #include "emucore/PropsSet.hxx"
 
 namespace ale {
 namespace stella {
 
+// The MD5 column of DefProps parsed to integers.  DefProps is generated in
+// sorted order, so this table is sorted too and shares its indices.
+static MD5Key def_props_keys[DEF_PROPS_SIZE];
+static std::once_flag def_props_keys_once;
+
+static const MD5Key* defPropsKeys()
+{
+  std::call_once(def_props_keys_once, []() {
+    for(int i = 0; i < DEF_PROPS_SIZE; ++i)
+      parseMD5Key(DefProps[i][Cartridge_MD5], 32, def_props_keys[i]);
+  });
+  return def_props_keys;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PropertiesSet::PropertiesSet()
   : myRoot(NULL),
@@ -74,27 +91,17 @@ void PropertiesSet::getMD5(const std::string& md5, Properties& properties,
   }
 
   // Otherwise, search the internal database using binary search
-  if(!found)
+  MD5Key key;
+  if(!found && parseMD5Key(md5, key))
   {
-    int low = 0, high = DEF_PROPS_SIZE - 1;
-    while(low <= high)
+    const MD5Key* keys = defPropsKeys();
+    const MD5Key* it = std::lower_bound(keys, keys + DEF_PROPS_SIZE, key);
+    if(it != keys + DEF_PROPS_SIZE && *it == key)
     {
-      int i = (low + high) / 2;
-      int cmp = std::strncmp(md5.c_str(), DefProps[i][Cartridge_MD5], 32);
-
-      if(cmp == 0)  // found it
-      {
-        for(int p = 0; p < LastPropType; ++p)
-          if(DefProps[i][p][0] != 0)
-            properties.set((PropertyType)p, DefProps[i][p]);
-
-        found = true;
-        break;
-      }
-      else if(cmp < 0)
-        high = i - 1; // look at lower range
-      else
-        low = i + 1;  // look at upper range
+      int i = it - keys;
+      for(int p = 0; p < LastPropType; ++p)
+        if(DefProps[i][p][0] != 0)
+          properties.set((PropertyType)p, DefProps[i][p]);
     }
   }
 }
@@ -199,5 +206,28 @@ uint32_t PropertiesSet::size() const
   return mySize;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t PropertiesSet::memoryUsage() const
+{
+  return sizeof(PropertiesSet) + nodeMemoryUsage(myRoot);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t PropertiesSet::nodeMemoryUsage(TreeNode* node) const
+{
+  if(!node)
+    return 0;
+
+  size_t bytes = sizeof(TreeNode) + sizeof(Properties);
+  for(int p = 0; p < LastPropType; ++p)
+  {
+    const std::string& value = node->props->myProperties[p];
+    if(value.capacity() > std::string().capacity())
+      bytes += value.capacity() + 1;
+  }
+
+  return bytes + nodeMemoryUsage(node->left) + nodeMemoryUsage(node->right);
+}
+
 }  // namespace stella
 }  // namespace ale
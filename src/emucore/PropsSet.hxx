@@ -85,6 +85,14 @@ class PropertiesSet
     */
     uint32_t size() const;
 
+    /**
+      Get the approximate number of bytes held by the collection.  The
+      built-in database is shared and not included.
+
+      @return  The size of the collection in bytes
+    */
+    size_t memoryUsage() const;
+
     /**
       Prints the contents of the PropertiesSet as a flat file.
     */
@@ -123,6 +131,13 @@ class PropertiesSet
     */
     void printNode(TreeNode* node) const;
 
+    /**
+      Get the number of bytes held by the current node and its children
+
+      @param node  The current subroot of the tree
+    */
+    size_t nodeMemoryUsage(TreeNode* node) const;
+
   private:
     // The root of the BST
     TreeNode* myRoot;
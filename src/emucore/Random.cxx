@@ -16,22 +16,18 @@
 // $Id: Random.cxx,v 1.4 2007/01/01 18:04:49 stephena Exp $
 //============================================================================
 
-#include <time.h>
+#include <algorithm>
+
 #include "emucore/Random.hxx"
 #include "emucore/Serializer.hxx"
 #include "emucore/Deserializer.hxx"
 
-// This uses C++11.
-#include <random>
-#include <sstream>
-
 namespace ale {
 namespace stella {
 
-// Implementation of Random's random number generator wrapper. 
+// Implementation of Random's random number generators. Both are written out
+// rather than taken from <random> so their state can be saved in binary.
 class Random::Impl {
-  
-  typedef std::mt19937 randgen_t;
 
   public:
     
@@ -40,41 +36,139 @@ class Random::Impl {
     // Implementations of the methods defined in Random.hpp.
     void seed(uint32_t value);
     uint32_t next();
+    void nextBlock(uint32_t* out, size_t n);
     double nextDouble();
 
   private:
    
     friend class Random;
 
-    // Seed to use for creating new random number generators
-    uint32_t m_seed;
+    // Regenerates the Mersenne Twister state once all of it has been used
+    void twist();
+
+    static const int MT_SIZE = 624;
+
+    // Generator to use from the next seed on
+    Generator m_selected;
+
+    // Generator in use
+    Generator m_generator;
 
-    // Random number generator 
-    randgen_t m_randgen; 
+    // Mersenne Twister state, and the index of the next word to temper
+    uint32_t m_mt[MT_SIZE];
+    int m_mt_index;
+
+    // xoshiro128++ state
+    uint32_t m_xoshiro[4];
 };
 
 Random::Impl::Impl()
+  : m_selected(MT19937),
+    m_generator(MT19937)
 {
-    // Initialize seed to time
+  seed(5489);  // std::mt19937's default seed
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Random::Impl::seed(uint32_t value)
 {
-  m_seed = value;
-  m_randgen.seed(m_seed);
+  m_generator = m_selected;
+  if(m_generator == MT19937)
+  {
+    m_mt[0] = value;
+    for(int i = 1; i < MT_SIZE; ++i)
+      m_mt[i] = 1812433253u * (m_mt[i - 1] ^ (m_mt[i - 1] >> 30)) + i;
+    m_mt_index = MT_SIZE;
+  }
+  else
+  {
+    // Expand the seed with splitmix64, as xoshiro's authors recommend
+    uint64_t x = value;
+    for(int i = 0; i < 4; i += 2)
+    {
+      uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      z ^= z >> 31;
+      m_xoshiro[i] = (uint32_t)z;
+      m_xoshiro[i + 1] = (uint32_t)(z >> 32);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Random::Impl::twist()
+{
+  for(int i = 0; i < MT_SIZE; ++i)
+  {
+    uint32_t y = (m_mt[i] & 0x80000000u) | (m_mt[(i + 1) % MT_SIZE] & 0x7fffffffu);
+    m_mt[i] = m_mt[(i + 397) % MT_SIZE] ^ (y >> 1) ^ ((y & 1) ? 0x9908b0dfu : 0);
+  }
+  m_mt_index = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uint32_t Random::Impl::next() 
 {
-  return m_randgen();
+  if(m_generator == MT19937)
+  {
+    if(m_mt_index >= MT_SIZE)
+      twist();
+
+    uint32_t y = m_mt[m_mt_index++];
+    y ^= y >> 11;
+    y ^= (y << 7) & 0x9d2c5680u;
+    y ^= (y << 15) & 0xefc60000u;
+    return y ^ (y >> 18);
+  }
+
+  uint32_t* s = m_xoshiro;
+  auto rotl = [](uint32_t x, int k) { return (x << k) | (x >> (32 - k)); };
+  uint32_t result = rotl(s[0] + s[3], 7) + s[0];
+  uint32_t t = s[1] << 9;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Random::Impl::nextBlock(uint32_t* out, size_t n)
+{
+  if(m_generator == MT19937)
+  {
+    // Temper runs of the current state, twisting as each one is used up
+    while(n > 0)
+    {
+      if(m_mt_index >= MT_SIZE)
+        twist();
+
+      size_t run = std::min(n, (size_t)(MT_SIZE - m_mt_index));
+      for(size_t i = 0; i < run; ++i)
+      {
+        uint32_t y = m_mt[m_mt_index++];
+        y ^= y >> 11;
+        y ^= (y << 7) & 0x9d2c5680u;
+        y ^= (y << 15) & 0xefc60000u;
+        *out++ = y ^ (y >> 18);
+      }
+      n -= run;
+    }
+  }
+  else
+  {
+    for(size_t i = 0; i < n; ++i)
+      out[i] = next();
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double Random::Impl::nextDouble()
 {
-  return m_randgen() / double(m_randgen.max() + 1.0);
+  return next() / 4294967296.0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -103,27 +197,77 @@ uint32_t Random::next()
   return m_pimpl->next();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Random::nextBlock(uint32_t* out, size_t n)
+{
+  m_pimpl->nextBlock(out, n);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double Random::nextDouble()
 {
   return m_pimpl->nextDouble();
 }
 
-bool Random::saveState(Serializer& ser) {
-  // The mt19937 object's serialization of choice is into a string. 
-  std::ostringstream oss;
-  oss << m_pimpl->m_randgen;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Random::setGenerator(const std::string& name)
+{
+  bool known = name == "mt19937" || name == "xoshiro128++";
+  m_pimpl->m_selected = name == "xoshiro128++" ? Xoshiro128PlusPlus : MT19937;
+  return known;
+}
 
-  ser.putString(oss.str());
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Random::saveState(Serializer& ser)
+{
+  ser.putInt(m_pimpl->m_generator);
+  if(m_pimpl->m_generator == MT19937)
+  {
+    // The words as little-endian bytes, rather than std::mt19937's decimal text
+    char words[Impl::MT_SIZE * 4];
+    for(int i = 0; i < Impl::MT_SIZE; ++i)
+      for(int b = 0; b < 4; ++b)
+        words[i * 4 + b] = (char)(m_pimpl->m_mt[i] >> (b * 8));
+    ser.putString(std::string_view(words, sizeof(words)));
+    ser.putInt(m_pimpl->m_mt_index);
+  }
+  else
+  {
+    for(uint32_t word : m_pimpl->m_xoshiro)
+      ser.putInt(word);
+  }
 
   return true;
 }
 
-bool Random::loadState(Deserializer& deser) {
-  // Deserialize into a string.
-  std::istringstream iss(deser.getString());
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Random::loadState(Deserializer& deser)
+{
+  int generator = deser.getInt();
+  if(generator == MT19937)
+  {
+    std::string_view words = deser.getStringView();
+    if(words.size() != Impl::MT_SIZE * 4)
+      return false;
+    for(int i = 0; i < Impl::MT_SIZE; ++i)
+    {
+      uint32_t word = 0;
+      for(int b = 0; b < 4; ++b)
+        word |= (uint32_t)(uint8_t)words[i * 4 + b] << (b * 8);
+      m_pimpl->m_mt[i] = word;
+    }
+    m_pimpl->m_mt_index = deser.getInt();
+  }
+  else if(generator == Xoshiro128PlusPlus)
+  {
+    for(uint32_t& word : m_pimpl->m_xoshiro)
+      word = (uint32_t)deser.getInt();
+  }
+  else
+    return false;
 
-  iss >> m_pimpl->m_randgen;
+  // States carry their generator, whatever the setting of this instance
+  m_pimpl->m_generator = (Generator)generator;
 
   return true;
 }
@@ -29,19 +29,36 @@ class Deserializer;
 }  // namespace stella
 }  // namespace ale
 
+#include <cstddef>
 #include <cstdint>
+#include <string>
 
 namespace ale {
 namespace stella {
 
 /**
-  This Random class uses a Mersenne Twister to provide pseudorandom numbers.
+  This Random class uses a Mersenne Twister to provide pseudorandom numbers,
+  or optionally xoshiro128++, whose state is a sixteenth of the size.
   The class itself is derived from the original 'Random' class by Bradford W. Mott.
 */
 class Random
 {
   public:
-    
+    enum Generator
+    {
+      MT19937,            // Same sequence as std::mt19937 for a given seed
+      Xoshiro128PlusPlus  // 16 bytes of state
+    };
+
+    /**
+      Select the generator by its name in the 'rng' setting, "mt19937" or
+      "xoshiro128++".  Takes effect at the next call to seed().
+
+      @param name The name of the generator
+      @return false if the name is unknown, in which case MT19937 is used
+    */
+    bool setGenerator(const std::string& name);
+
     /**
       Class method which allows you to set the seed that'll be used
       for created new instances of this class
@@ -64,6 +81,15 @@ class Random
     */
     uint32_t next();
 
+    /**
+      Answer the next n random numbers, the same as n calls to next() but
+      without a call per number
+
+      @param out The array to store the random numbers in
+      @param n   The number of random numbers
+    */
+    void nextBlock(uint32_t* out, size_t n);
+
     /**
       Answer the next random number between 0 and 1 from the random number generator
 
@@ -72,7 +98,7 @@ class Random
     double nextDouble();
 
     /**
-      Serializes the RNG state.
+      Serializes the RNG state in binary, including which generator is used.
     */
     bool saveState(Serializer& out);
 
@@ -23,46 +23,47 @@ namespace ale {
 namespace stella {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Serializer::Serializer(void) {
-    myStream.clear();
-    
+Serializer::Serializer(void)
+  : myBuffer(&myOwnBuffer)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(std::string& buffer)
+  : myBuffer(&buffer)
+{
+  myBuffer->clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::~Serializer(void)
 {
-    close();
+  close();
 }
 
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::close(void)
 {
-    myStream.clear();
 }
 
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putInt(int value)
 {
-    unsigned char buf[4];
+    char buf[4];
     for(int i = 0; i < 4; ++i)
-        buf[i] = (value >> (i<<3)) & 0xff;
-    
-    myStream.write((char*)buf, 4);
-    if(myStream.bad())
-        throw "Serializer: file write failed";
+        buf[i] = (char)((value >> (i<<3)) & 0xff);
+
+    myBuffer->append(buf, 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putString(const std::string& str)
+void Serializer::putString(std::string_view str)
 {
     int len = str.length();
     putInt(len);
-    myStream.write(str.data(), (std::streamsize)len);
-    
-    if(myStream.bad())
-        throw "Serializer: file write failed";
+    myBuffer->append(str.data(), len);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -73,4 +74,3 @@ void Serializer::putBool(bool b)
 
 }  // namespace stella
 }  // namespace ale
-
@@ -19,7 +19,8 @@
 #ifndef SERIALIZER_HXX
 #define SERIALIZER_HXX
 
-#include <sstream>
+#include <string>
+#include <string_view>
 
 namespace ale {
 namespace stella {
@@ -35,30 +36,37 @@ namespace stella {
 
   @author  Stephen Anthony
   @version $Id: Serializer.hxx,v 1.12 2007/01/01 18:04:49 stephena Exp $
-  
+
   Revised for ALE on Sep 20, 2009
-  The new version uses a stringstream (not a file stream)
+  The new version writes to a string (not a file stream), either its own or
+  one given by the caller, whose capacity is then reused.
 */
 class Serializer
 {
   public:
     /**
       Creates a new Serializer device.
-
     */
     Serializer(void);
 
+    /**
+      Creates a Serializer device writing into the given string, which is
+      cleared first.  The string must outlive the Serializer.
+
+      @param buffer The string to write the serialized data to.
+    */
+    explicit Serializer(std::string& buffer);
+
     /**
       Destructor
     */
     virtual ~Serializer(void);
 
-
     /**
       Closes the current output stream.
     */
     void close(void);
-    
+
     bool isOpen(void) {return true;}
 
     /**
@@ -73,7 +81,7 @@ class Serializer
 
       @param str The string to write to the output stream.
     */
-    void putString(const std::string& str);
+    void putString(std::string_view str);
 
     /**
       Writes a boolean value to the current output stream.
@@ -82,14 +90,15 @@ class Serializer
     */
     void putBool(bool b);
 
-    // Accessor for myStream
-    // TODO: don't copy the whole streams. 
+    // Accessor for the serialized data
     std::string get_str(void) const {
-        return myStream.str();
+        return *myBuffer;
     }
+
   private:
-    // The stream to send the serialized data to.
-    std::stringstream myStream;
+    // The string to send the serialized data to, myOwnBuffer unless one was given
+    std::string myOwnBuffer;
+    std::string* myBuffer;
 
     enum {
       TruePattern  = 0xfab1fab2,
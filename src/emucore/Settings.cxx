@@ -17,10 +17,11 @@
 //============================================================================
 
 #include <cassert>
+#include <cstdlib>
 #include <sstream>
-#include <fstream>
 #include <algorithm>
 #include <string>
+#include <unordered_map>
 
 #include "emucore/OSystem.hxx"
 #include "emucore/Settings.hxx"
@@ -29,107 +30,208 @@ namespace ale {
 namespace stella {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Settings::Settings(OSystem* osystem) : myOSystem(osystem) {
+const Settings::Definition Settings::ourDefinitions[LastSettingType] = {
+  // Stella settings
+  { "palette",                    AnyKind,    "standard" },
+  { "sound",                      AnyKind,    "false" },
+  { "fragsize",                   AnyKind,    "64" },     // 64 ensures proper sound sync
+  { "freq",                       AnyKind,    "31400" },
+  { "tiafreq",                    AnyKind,    "31400" },
+  { "volume",                     AnyKind,    "100" },
+  { "clipvol",                    AnyKind,    "true" },
+
+  // Reduce CPU emulation fidelity for speed
+  { "cpu",                        StringKind, "low" },
+  // Random seed for ale::stella::System.
+  // This random seed should be fixed to enable full determinism in the ALE
+  { "system_random_seed",         IntKind,    "4753849" },
+  // Random number generator for the system and sticky actions:
+  // "mt19937" or "xoshiro128++", whose state is far smaller to save
+  { "rng",                        StringKind, "mt19937" },
+
+  // Controller settings
+  { "max_num_frames",             IntKind,    "0" },
+  { "max_num_frames_per_episode", IntKind,    "0" },
+
+  // Expose paddle_min and paddle_max settings but set as 'undefined' so
+  // PADDLE_MIN and PADDLE_MAX defines are used as for default values in
+  // the StellaEnvironment constructor.
+  { "paddle_min",                 IntKind,    "-1" },
+  { "paddle_max",                 IntKind,    "-1" },
+
+  // FIFO controller settings
+  { "run_length_encoding",        BoolKind,   "1" },
+
+  // Environment customization settings
+  { "restricted_action_set",      BoolKind,   "0" },
+  { "random_seed",                IntKind,    "-1" },
+  { "color_averaging",            BoolKind,   "0" },
+  { "send_rgb",                   BoolKind,   "0" },
+  { "sound_obs",                  BoolKind,   "0" },
+  { "frame_skip",                 IntKind,    "1" },
+  // When greater than frame_skip, each step emulates a number of frames
+  // drawn uniformly from frame_skip to frame_skip_max
+  { "frame_skip_max",             IntKind,    "0" },
+  { "repeat_action_probability",  FloatKind,  "0.25" },
+  // Each episode starts with a number of NOOP frames drawn uniformly from
+  // 1 to noop_max, or none if it is 0
+  { "noop_max",                   IntKind,    "0" },
+  // Keep the state reached by each distinct reset and restore it rather
+  // than emulating the reset again
+  { "cache_resets",               BoolKind,   "0" },
+  // Emulate without drawing the screen, for agents that only read the RAM
+  { "ram_only",                   BoolKind,   "0" },
+  { "rom_file",                   StringKind, "" },
+
+  // Record settings
+  { "record_screen_dir",          StringKind, "" },
+  { "record_screen_file",         StringKind, "" },
+  { "record_sound_filename",      StringKind, "" },
+
+  // Display Settings
+  { "display_screen",             BoolKind,   "0" },
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Settings::Settings(OSystem* osystem)
+  : myOSystem(osystem),
+    myNeedsValidation(true)
+{
     // Add this settings object to the OSystem
     myOSystem->attach(this);
 
-    setInternal("palette", "standard");
-
-    setInternal("sound", "false");
-    setInternal("fragsize", "512");
-    setInternal("freq", "31400");
-    setInternal("tiafreq", "31400");
-    setInternal("volume", "100");
-    setInternal("clipvol", "true");
-
     setDefaultSettings();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Settings::~Settings()
 {
-  myInternalSettings.clear();
-  myExternalSettings.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::validate()
 {
+  // Settings are validated in one batch before they're used, so there is
+  // nothing to do unless something was set since the last time
+  if(!myNeedsValidation)
+    return;
+
   std::string s;
-  int i;
 
 #ifdef SDL_SUPPORT
-  i = getInt("volume");
+  int i = getInt(Setting_Volume);
   if(i < 0 || i > 100)
-    setInternal("volume", "100");
-  i = getInt("freq");
+    assign(Setting_Volume, "100");
+  i = getInt(Setting_Freq);
   if(i < 0 || i > 48000)
-    setInternal("freq", "31400");
-  i = getInt("tiafreq");
+    assign(Setting_Freq, "31400");
+  i = getInt(Setting_TiaFreq);
   if(i < 0 || i > 48000)
-    setInternal("tiafreq", "31400");
+    assign(Setting_TiaFreq, "31400");
 #endif
 
-  s = getString("palette");
+  s = getString(Setting_Palette);
   if(s != "standard" && s != "z26" && s != "user")
-    setInternal("palette", "standard");
+    assign(Setting_Palette, "standard");
+
+  s = getString(Setting_Rng);
+  if(s != "mt19937" && s != "xoshiro128++")
+  {
+    ale::Logger::Warning << "Unknown rng " << s << ", using mt19937" << std::endl;
+    assign(Setting_Rng, "mt19937");
+  }
+
+  myNeedsValidation = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Settings::setInt(const std::string& key, const int value)
+void Settings::assign(SettingType key, const std::string& value)
 {
-  std::ostringstream stream;
-  stream << value;
+  Value& v = myValues[key];
+  v.value = value;
+  v.intValue = atoi(value.c_str());
+  v.floatValue = (float) atof(value.c_str());
+  v.boolValue = value == "1" || value == "true" || value == "True";
 
-  if(int idx = getInternalPos(key) != -1){
-    setInternal(key, stream.str(), idx);
-  }
-  else{
-    verifyVariableExistence(intSettings, key);
-    setExternal(key, stream.str());
+  myNeedsValidation = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SettingType Settings::lookup(const std::string& key)
+{
+  static const std::unordered_map<std::string, SettingType> ids = [] {
+    std::unordered_map<std::string, SettingType> ids;
+    for(int i = 0; i < LastSettingType; ++i)
+      ids.emplace(ourDefinitions[i].key, (SettingType)i);
+    return ids;
+  }();
+
+  auto it = ids.find(key);
+  return it == ids.end() ? LastSettingType : it->second;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SettingType Settings::checkedLookup(const std::string& key, Kind kind)
+{
+  SettingType id = lookup(key);
+  if(id == LastSettingType ||
+     (ourDefinitions[id].kind != AnyKind && ourDefinitions[id].kind != kind))
+  {
+    throw std::runtime_error("The key " + key + " you are trying to set does not exist or has incorrect value type.\n");
   }
+  return id;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Settings::setFloat(const std::string& key, const float value)
+void Settings::setInt(SettingType key, const int value)
 {
   std::ostringstream stream;
   stream << value;
-
-  if(int idx = getInternalPos(key) != -1){
-    setInternal(key, stream.str(), idx);
-  }
-  else{
-    verifyVariableExistence(floatSettings, key);
-    setExternal(key, stream.str());
-  }
+  assign(key, stream.str());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Settings::setBool(const std::string& key, const bool value)
+void Settings::setFloat(SettingType key, const float value)
 {
   std::ostringstream stream;
   stream << value;
+  assign(key, stream.str());
+}
 
-  if(int idx = getInternalPos(key) != -1){
-    setInternal(key, stream.str(), idx);
-  }
-  else{
-    verifyVariableExistence(boolSettings, key);
-    setExternal(key, stream.str());
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::setBool(SettingType key, const bool value)
+{
+  assign(key, value ? "1" : "0");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::setString(SettingType key, const std::string& value)
+{
+  assign(key, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::setInt(const std::string& key, const int value)
+{
+  setInt(checkedLookup(key, IntKind), value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::setFloat(const std::string& key, const float value)
+{
+  setFloat(checkedLookup(key, FloatKind), value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::setBool(const std::string& key, const bool value)
+{
+  setBool(checkedLookup(key, BoolKind), value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::setString(const std::string& key, const std::string& value)
 {
-  if(int idx = getInternalPos(key) != -1){
-    setInternal(key, value, idx);
-  }
-  else{
-    verifyVariableExistence(stringSettings, key);
-    setExternal(key, value);
-  }
+  setString(checkedLookup(key, StringKind), value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -142,98 +244,57 @@ void Settings::getSize(const std::string& key, int& x, int& y) const
   buf >> y;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void missingSetting(const std::string& key)
+{
+  ale::Logger::Error << "No value found for key: " << key << ". ";
+  ale::Logger::Error << "Make sure all the settings files are loaded." << std::endl;
+  exit(-1);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Settings::getInt(const std::string& key, bool strict) const {
     // Try to find the named setting and answer its value
-    int idx = -1;
-    if((idx = getInternalPos(key)) != -1) {
-        return (int) atoi(myInternalSettings[idx].value.c_str());
-    } else { 
-        if((idx = getExternalPos(key)) != -1) {
-            return (int) atoi(myExternalSettings[idx].value.c_str());
-        } else {
-            if (strict) {
-                ale::Logger::Error << "No value found for key: " << key << ". ";
-                ale::Logger::Error << "Make sure all the settings files are loaded." << std::endl;
-                exit(-1);
-            } else {
-                return -1;
-            }
-        }
-    }
+    SettingType id = lookup(key);
+    if(id != LastSettingType)
+        return getInt(id);
+    if(strict)
+        missingSetting(key);
+    return -1;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 float Settings::getFloat(const std::string& key, bool strict) const {
     // Try to find the named setting and answer its value
-    int idx = -1;
-    if((idx = getInternalPos(key)) != -1) {
-        return (float) atof(myInternalSettings[idx].value.c_str());
-    } else { 
-        if((idx = getExternalPos(key)) != -1) {
-            return (float) atof(myExternalSettings[idx].value.c_str());
-        } else {
-            if (strict) {
-                ale::Logger::Error << "No value found for key: " << key << ". ";
-                ale::Logger::Error << "Make sure all the settings files are loaded." << std::endl;
-                exit(-1);
-            } else {
-                return -1.0;
-            }
-        }
-    }
+    SettingType id = lookup(key);
+    if(id != LastSettingType)
+        return getFloat(id);
+    if(strict)
+        missingSetting(key);
+    return -1.0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Settings::getBool(const std::string& key, bool strict) const {
     // Try to find the named setting and answer its value
-    int idx = -1;
-    if((idx = getInternalPos(key)) != -1)
-    {
-        const std::string& value = myInternalSettings[idx].value;
-        if(value == "1" || value == "true" || value == "True")
-            return true;
-        else if(value == "0" || value == "false" || value == "False")
-            return false;
-        else
-            return false;
-    } else if((idx = getExternalPos(key)) != -1) {
-        const std::string& value = myExternalSettings[idx].value;
-        if(value == "1" || value == "true")
-            return true;
-        else if(value == "0" || value == "false")
-            return false;
-        else
-            return false;
-    } else {
-        if (strict) {
-            ale::Logger::Error << "No value found for key: " << key << ". ";
-            ale::Logger::Error << "Make sure all the settings files are loaded." << std::endl;
-            exit(-1);
-        } else {
-            return false;
-        }
-    }
+    SettingType id = lookup(key);
+    if(id != LastSettingType)
+        return getBool(id);
+    if(strict)
+        missingSetting(key);
+    return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const std::string& Settings::getString(const std::string& key, bool strict) const {
     // Try to find the named setting and answer its value
-    int idx = -1;
-    if((idx = getInternalPos(key)) != -1) {
-        return myInternalSettings[idx].value;
-    } else if ((idx = getExternalPos(key)) != -1) {
-        return myExternalSettings[idx].value;
-    } else {
-        if (strict) {
-            ale::Logger::Error << "No value found for key: " << key << ". ";
-            ale::Logger::Error << "Make sure all the settings files are loaded." << std::endl;
-            exit(-1);
-        } else {
-            static std::string EmptyString("");
-            return EmptyString; 
-        }
-    }
+    SettingType id = lookup(key);
+    if(id != LastSettingType)
+        return getString(id);
+    if(strict)
+        missingSetting(key);
+    static std::string EmptyString("");
+    return EmptyString;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -245,131 +306,14 @@ void Settings::setSize(const std::string& key, const int value1, const int value
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Settings::getInternalPos(const std::string& key) const
-{
-  for(unsigned int i = 0; i < myInternalSettings.size(); ++i)
-    if(myInternalSettings[i].key == key)
-      return i;
-
-  return -1;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Settings::getExternalPos(const std::string& key) const
-{
-  for(unsigned int i = 0; i < myExternalSettings.size(); ++i)
-    if(myExternalSettings[i].key == key)
-      return i;
-
-  return -1;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Settings::setInternal(const std::string& key, const std::string& value,
-                          int pos, bool useAsInitial)
-{
-  int idx = -1;
-
-  if(pos != -1 && pos >= 0 && pos < (int)myInternalSettings.size() &&
-     myInternalSettings[pos].key == key)
-  {
-    idx = pos;
-  }
-  else
-  {
-    for(unsigned int i = 0; i < myInternalSettings.size(); ++i)
-    {
-      if(myInternalSettings[i].key == key)
-      {
-        idx = i;
-        break;
-      }
-    }
-  }
-
-  if(idx != -1)
-  {
-    myInternalSettings[idx].key   = key;
-    myInternalSettings[idx].value = value;
-    if(useAsInitial) myInternalSettings[idx].initialValue = value;
-
-    /*cerr << "modify internal: key = " << key
-         << ", value  = " << value
-         << ", ivalue = " << myInternalSettings[idx].initialValue
-         << " @ index = " << idx
-         << endl;*/
-  }
-  else
-  {
-    Setting setting;
-    setting.key   = key;
-    setting.value = value;
-    if(useAsInitial) setting.initialValue = value;
-
-    myInternalSettings.push_back(setting);
-    idx = myInternalSettings.size() - 1;
-
-    /*cerr << "insert internal: key = " << key
-         << ", value  = " << value
-         << ", ivalue = " << setting.initialValue
-         << " @ index = " << idx
-         << endl;*/
-  }
-
-  return idx;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Settings::setExternal(const std::string& key, const std::string& value,
-                          int pos, bool useAsInitial)
+size_t Settings::memoryUsage() const
 {
-  int idx = -1;
-
-  if(pos != -1 && pos >= 0 && pos < (int)myExternalSettings.size() &&
-     myExternalSettings[pos].key == key)
-  {
-    idx = pos;
-  }
-  else
-  {
-    for(unsigned int i = 0; i < myExternalSettings.size(); ++i)
-    {
-      if(myExternalSettings[i].key == key)
-      {
-        idx = i;
-        break;
-      }
-    }
-  }
-
-  if(idx != -1)
-  {
-    myExternalSettings[idx].key   = key;
-    myExternalSettings[idx].value = value;
-    if(useAsInitial) myExternalSettings[idx].initialValue = value;
-
-    /*cerr << "modify external: key = " << key
-         << ", value = " << value
-         << " @ index = " << idx
-         << endl;*/
-  }
-  else
-  {
-    Setting setting;
-    setting.key   = key;
-    setting.value = value;
-    if(useAsInitial) setting.initialValue = value;
-
-    myExternalSettings.push_back(setting);
-    idx = myExternalSettings.size() - 1;
-
-    /*cerr << "insert external: key = " << key
-         << ", value = " << value
-         << " @ index = " << idx
-         << endl;*/
-  }
+  size_t bytes = sizeof(Settings);
+  for(const Value& v: myValues)
+    if(v.value.capacity() > std::string().capacity())
+      bytes += v.value.capacity() + 1;
 
-  return idx;
+  return bytes;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -387,66 +331,8 @@ Settings& Settings::operator = (const Settings&)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::setDefaultSettings() {
-
-    // Stella settings
-    stringSettings.insert(std::pair<std::string, std::string>("cpu", "low")); // Reduce CPU emulation fidelity for speed
-    // Random seed for ale::stella::System.
-    // This random seed should be fixed to enable full determinism in the ALE
-    intSettings.insert(std::pair<std::string, int>("system_random_seed", 4753849));
-
-    // Controller settings
-    intSettings.insert(std::pair<std::string, int>("max_num_frames", 0));
-    intSettings.insert(std::pair<std::string, int>("max_num_frames_per_episode", 0));
-
-    // Expose paddle_min and paddle_max settings but set as 'undefined' so
-    // PADDLE_MIN and PADDLE_MAX defines are used as for default values in
-    // the StellaEnvironment constructor.
-    intSettings.insert(std::pair<std::string, int>("paddle_min", -1));
-    intSettings.insert(std::pair<std::string, int>("paddle_max", -1));
-
-    // FIFO controller settings
-    boolSettings.insert(std::pair<std::string, bool>("run_length_encoding", true));
-
-    // Environment customization settings
-    boolSettings.insert(std::pair<std::string, bool>("restricted_action_set", false));
-    intSettings.insert(std::pair<std::string, int>("random_seed", -1));
-    boolSettings.insert(std::pair<std::string, bool>("color_averaging", false));
-    boolSettings.insert(std::pair<std::string, bool>("send_rgb", false));
-    intSettings.insert(std::pair<std::string, int>("frame_skip", 1));
-    floatSettings.insert(std::pair<std::string, float>("repeat_action_probability", 0.25));
-    stringSettings.insert(std::pair<std::string, std::string>("rom_file", ""));
-
-    // Record settings
-    intSettings.insert(std::pair<std::string, int>("fragsize", 64)); // fragsize to 64 ensures proper sound sync
-    stringSettings.insert(std::pair<std::string, std::string>("record_screen_dir", ""));
-    stringSettings.insert(std::pair<std::string, std::string>("record_sound_filename", ""));
-
-    // Display Settings
-    boolSettings.insert(std::pair<std::string, bool>("display_screen", false));
-
-    for(std::map<std::string, std::string>::iterator it = stringSettings.begin(); it != stringSettings.end(); it++) {
-      this->setString(it->first, it->second);
-    }
-
-    for(std::map<std::string, float>::iterator it = floatSettings.begin(); it != floatSettings.end(); it++) {
-      this->setFloat(it->first, it->second);
-    }
-
-    for(std::map<std::string, bool>::iterator it = boolSettings.begin(); it != boolSettings.end(); it++) {
-      this->setBool(it->first, it->second);
-    }
-
-    for(std::map<std::string, int>::iterator it = intSettings.begin(); it != intSettings.end(); it++) {
-      this->setInt(it->first, it->second);
-    }
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-template<typename ValueType>
-void Settings::verifyVariableExistence(std::map<std::string, ValueType> dict, std::string key){
-    if(dict.find(key) == dict.end()){
-      throw std::runtime_error("The key " + key + " you are trying to set does not exist or has incorrect value type.\n");
-    }
+    for(int i = 0; i < LastSettingType; ++i)
+      assign((SettingType)i, ourDefinitions[i].defaultValue);
 }
 
 }  // namespace stella
@@ -27,14 +27,57 @@ class OSystem;
 }  // namespace stella
 }  // namespace ale
 
-#include <map>
-#include <vector>
+#include <cstddef>
+#include <string>
 #include <stdexcept>
 
 
 namespace ale {
 namespace stella {
 
+/**
+  Identifiers for every setting the emulator knows about.  Typed access
+  by identifier is plain array indexing; the string keys used by the
+  frontends are resolved to these once per call.
+*/
+enum SettingType {
+  // Stella settings, which accept values of any type
+  Setting_Palette,
+  Setting_Sound,
+  Setting_Fragsize,
+  Setting_Freq,
+  Setting_TiaFreq,
+  Setting_Volume,
+  Setting_ClipVol,
+
+  // ALE settings
+  Setting_Cpu,
+  Setting_SystemRandomSeed,
+  Setting_Rng,
+  Setting_MaxNumFrames,
+  Setting_MaxNumFramesPerEpisode,
+  Setting_PaddleMin,
+  Setting_PaddleMax,
+  Setting_RunLengthEncoding,
+  Setting_RestrictedActionSet,
+  Setting_RandomSeed,
+  Setting_ColorAveraging,
+  Setting_SendRGB,
+  Setting_SoundObs,
+  Setting_FrameSkip,
+  Setting_FrameSkipMax,
+  Setting_RepeatActionProbability,
+  Setting_NoopMax,
+  Setting_CacheResets,
+  Setting_RamOnly,
+  Setting_RomFile,
+  Setting_RecordScreenDir,
+  Setting_RecordScreenFile,
+  Setting_RecordSoundFilename,
+  Setting_DisplayScreen,
+  LastSettingType
+};
+
 /**
   This class provides an interface for accessing frontend specific settings.
 
@@ -58,9 +101,42 @@ class Settings
     /**
       This method should be called *after* settings have been read,
       to validate (and change, if necessary) any improper settings.
+      It is cheap to call when nothing has changed since the last call.
     */
     void validate();
 
+    /**
+      Get the value of the specified setting.  These never fail and
+      should be preferred over the string keyed versions.
+
+      @param key The setting to lookup
+      @return The value of the setting
+    */
+    int getInt(SettingType key) const { return myValues[key].intValue; }
+    float getFloat(SettingType key) const { return myValues[key].floatValue; }
+    bool getBool(SettingType key) const { return myValues[key].boolValue; }
+    const std::string& getString(SettingType key) const
+      { return myValues[key].value; }
+
+    /**
+      Set the value of the specified setting.
+
+      @param key   The setting to change
+      @param value The value to assign to the setting
+    */
+    void setInt(SettingType key, const int value);
+    void setFloat(SettingType key, const float value);
+    void setBool(SettingType key, const bool value);
+    void setString(SettingType key, const std::string& value);
+
+    /**
+      Get the identifier of the setting with the given name.
+
+      @param key The name of the setting
+      @return The identifier, or LastSettingType if there is no such setting
+    */
+    static SettingType lookup(const std::string& key);
+
     /**
       Get the value assigned to the specified key.  If the key does
       not exist then -1 is returned.
@@ -107,7 +183,8 @@ class Settings
     void getSize(const std::string& key, int& x, int& y) const;
 
     /**
-      Set the value associated with key to the given value.
+      Set the value associated with key to the given value.  An exception
+      is thrown if the key does not exist or holds a different type.
 
       @param key   The key of the setting
       @param value The value to assign to the setting
@@ -146,6 +223,12 @@ class Settings
     */
     void setSize(const std::string& key, const int value1, const int value2);
 
+    /**
+      Answers the approximate number of bytes held by this object,
+      including the keys and values of all settings.
+    */
+    size_t memoryUsage() const;
+
 
   private:
     // Copy constructor isn't supported by this class so make it private
@@ -165,51 +248,43 @@ class Settings
     // Sets all of the ALE-specific default settings
     void setDefaultSettings();
 
+    // Store the value of a setting in its text and parsed forms
+    void assign(SettingType key, const std::string& value);
+
+    // The type of value a setting holds; Stella's own settings take any
+    enum Kind { IntKind, FloatKind, BoolKind, StringKind, AnyKind };
+
+    // Resolve a key for one of the string keyed setters, throwing if the
+    // key does not exist or the setting holds a different type
+    static SettingType checkedLookup(const std::string& key, Kind kind);
+
   protected:
     // The parent OSystem object
     OSystem* myOSystem;
 
-    // Structure used for storing settings
-    struct Setting
+  private:
+    // The value of a setting as text, along with its parsed forms
+    struct Value
     {
-      std::string key;
       std::string value;
-      std::string initialValue;
+      int intValue;
+      float floatValue;
+      bool boolValue;
     };
-    typedef std::vector<Setting> SettingsArray;
-
-    const SettingsArray& getInternalSettings() const
-      { return myInternalSettings; }
-    const SettingsArray& getExternalSettings() const
-      { return myExternalSettings; }
 
-    /** Get position in specified array of 'key' */
-    int getInternalPos(const std::string& key) const;
-    int getExternalPos(const std::string& key) const;
+    Value myValues[LastSettingType];
 
-    /** Add key,value pair to specified array at specified position */
-    int setInternal(const std::string& key, const std::string& value,
-                    int pos = -1, bool useAsInitial = false);
-    int setExternal(const std::string& key, const std::string& value,
-                    int pos = -1, bool useAsInitial = false);
+    // Name, type and default value of every setting, indexed by SettingType
+    struct Definition
+    {
+      const char* key;
+      Kind kind;
+      const char* defaultValue;
+    };
+    static const Definition ourDefinitions[LastSettingType];
 
-  private:
-    //Maps containing all external settings an user can
-    //define and their respectives default values.
-    std::map<std::string,int> intSettings;
-    std::map<std::string,bool> boolSettings;
-    std::map<std::string,float> floatSettings;
-    std::map<std::string,std::string> stringSettings;
-    template<typename ValueType>
-    void verifyVariableExistence(std::map<std::string, ValueType> dict, std::string key);
-
-    // Holds key,value pairs that are necessary for Stella to
-    // function and must be saved on each program exit.
-    SettingsArray myInternalSettings;
-
-    // Holds auxiliary key,value pairs that shouldn't be saved on
-    // program exit.
-    SettingsArray myExternalSettings;
+    // Whether any setting changed since the last validate()
+    bool myNeedsValidation;
 };
 
 }  // namespace stella
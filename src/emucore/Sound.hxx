@@ -19,6 +19,9 @@
 #ifndef SOUND_HXX
 #define SOUND_HXX
 
+#include <cstdint>
+#include <vector>
+
 namespace ale {
 namespace stella {
   
@@ -141,6 +144,23 @@ class Sound
       */
     virtual void recordNextFrame() = 0;
 
+    /**
+      Tells the sound engine that the TIA finished a frame.
+
+      @param cycle The system cycle at which the frame ended
+    */
+    virtual void endFrame(int /*cycle*/) { }
+
+    /**
+      Returns the samples generated for the last finished frame.  Empty
+      unless the sound engine generates samples per frame.
+    */
+    virtual const std::vector<uint8_t>& frameSamples() const
+    {
+      static const std::vector<uint8_t> none;
+      return none;
+    }
+
 public:
     /**
       Loads the current state of this device from the given Deserializer.
@@ -21,6 +21,7 @@
 
 #include "emucore/Device.hxx"
 #include "emucore/M6502.hxx"
+#include "emucore/M6532.hxx"
 #include "emucore/TIA.hxx"
 #include "emucore/System.hxx"
 #include "emucore/Serializer.hxx"
@@ -35,11 +36,13 @@ System::System(Settings& settings)
   : myNumberOfDevices(0),
     myM6502(0),
     myTIA(0),
+    myM6532(0),
     myCycles(0),
     myDataBusState(0)
 {
   // Seed RNG with fixed seed to enable full determinism
-  int32_t emulatorSeed = settings.getInt("system_random_seed");
+  int32_t emulatorSeed = settings.getInt(Setting_SystemRandomSeed);
+  myRandom.setGenerator(settings.getString(Setting_Rng));
   myRandom.seed(emulatorSeed);
 
   // Allocate page table
@@ -123,6 +126,13 @@ void System::attach(TIA* tia)
   attach((Device*) tia);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::attach(M6532* m6532)
+{
+  myM6532 = m6532;
+  attach((Device*) m6532);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool System::save(Serializer& out)
 {
@@ -256,7 +266,7 @@ bool System::loadState(const std::string& md5sum, Deserializer& in)
   {
     // Look at the beginning of the state file.  It should contain the md5sum
     // of the current cartridge.  If it doesn't, this state file is invalid.
-    if(in.getString() != md5sum)
+    if(in.getStringView() != md5sum)
       return false;
 
     // First load state for this system
@@ -24,6 +24,7 @@ namespace stella {
 
 class Device;
 class M6502;
+class M6532;
 class TIA;
 class NullDevice;
 class Serializer;
@@ -36,6 +37,7 @@ class Settings;
 #include "emucore/Device.hxx"
 #include "emucore/NullDev.hxx"
 #include "emucore/Random.hxx"
+#include "common/PerfCounters.hpp"
 
 #include <string>
 
@@ -123,6 +125,14 @@ class System
     */
     void attach(TIA* tia);
 
+    /**
+      Attach the specified 6532 device to the system, remembering it so
+      its RAM can be read directly.
+
+      @param m6532 The 6532 device to attach to the system
+    */
+    void attach(M6532* m6532);
+
     /**
       Saves the current state of Stella to the given file.  Calls
       save on every device and CPU attached to this system.
@@ -167,6 +177,16 @@ class System
       return *myTIA;
     }
 
+    /**
+      Answer the 6532 device attached to the system.
+
+      @return The attached 6532 device
+    */
+    M6532& m6532()
+    {
+      return *myM6532;
+    }
+
     /**
       Answer the random generator attached to the system.
       @return The random generator
@@ -176,6 +196,17 @@ class System
       return myRandom;
     }
 
+    /**
+      Answer the hot-path counters of this system and its devices.  They
+      are only updated when built with ALE_PERF_COUNTERS.
+
+      @return The performance counters
+    */
+    PerfStats& perfStats()
+    {
+      return myPerfStats;
+    }
+
     /**
       Get the null device associated with the system.  Every system 
       has a null device associated with it that's used by pages which 
@@ -273,10 +304,12 @@ class System
       // See if this page uses direct accessing or not
       if(access.directPeekBase != 0)
       {
+        ALE_PERF_COUNT(myPerfStats, PERF_DIRECT_PEEKS, 1);
         result = *(access.directPeekBase + (addr & myPageMask));
       }
       else
       {
+        ALE_PERF_COUNT(myPerfStats, PERF_DEVICE_PEEKS, 1);
         result = access.device->peek(addr);
       }
 
@@ -300,10 +333,12 @@ class System
       // See if this page uses direct accessing or not
       if(access.directPokeBase != 0)
       {
+        ALE_PERF_COUNT(myPerfStats, PERF_DIRECT_POKES, 1);
         *(access.directPokeBase + (addr & myPageMask)) = value;
       }
       else
       {
+        ALE_PERF_COUNT(myPerfStats, PERF_DEVICE_POKES, 1);
         access.device->poke(addr, value);
       }
 
@@ -398,6 +433,9 @@ class System
     // TIA device attached to the system or the null pointer
     TIA* myTIA;
 
+    // 6532 device attached to the system or the null pointer
+    M6532* myM6532;
+
     // Many devices need a source of random numbers, usually for emulating
     // unknown/undefined behaviour
     Random myRandom;
@@ -416,6 +454,9 @@ class System
     // debugger is active.
     bool myDataBusLocked;
 
+    // Hot-path counters, see common/PerfCounters.hpp
+    PerfStats myPerfStats;
+
   private:
     // Copy constructor isn't supported by this class so make it private
     System(const System&);
@@ -16,6 +16,7 @@
 // $Id: TIA.cxx,v 1.79 2007/02/06 23:34:33 stephena Exp $
 //============================================================================
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <mutex>
@@ -53,9 +54,10 @@ TIA::TIA(const Console& console, Settings& settings)
 {
   uint32_t i;
 
-  // Allocate buffers for two frame buffers
-  myCurrentFrameBuffer = new uint8_t[160 * 300];
-  myPreviousFrameBuffer = new uint8_t[160 * 300];
+  // The frame buffers are sized to the display height on reset
+  myCurrentFrameBuffer = NULL;
+  myPreviousFrameBuffer = NULL;
+  myFrameBufferSize = 0;
 
   myFrameGreyed = false;
   myPartialFrameFlag = false; //ALE : This was left uninitialized :(
@@ -117,6 +119,7 @@ TIA::TIA(const Console& console, Settings& settings)
   myAUDV0 = myAUDV1 = myAUDF0 = myAUDF1 = myAUDC0 = myAUDC1 = 0;
 
   fastUpdate = settings.getBool("fast_tia_update", false);
+  myRenderPixels = !settings.getBool(Setting_RamOnly);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -222,6 +225,7 @@ void TIA::reset()
 void TIA::frameReset()
 {
   // Clear frame buffers
+  resizeBuffers();
   clearBuffers();
 
   // Reset pixel pointer and drawing flag
@@ -387,6 +391,11 @@ bool TIA::save(Serializer& out)
     out.putBool(myDumpEnabled);
     out.putInt(myDumpDisabledCycle);
 
+    // A frame may be left unfinished, in which case the next update
+    // continues it rather than starting a new one
+    out.putBool(myPartialFrameFlag);
+    out.putInt(myFramePointer - myCurrentFrameBuffer);
+
     // Save the sound sample stuff ...
     mySound->save(out);
   }
@@ -484,6 +493,9 @@ bool TIA::load(Deserializer& in)
     myDumpEnabled = in.getBool();
     myDumpDisabledCycle = (int) in.getInt();
 
+    myPartialFrameFlag = in.getBool();
+    myFramePointer = myCurrentFrameBuffer + in.getInt();
+
     // Load the sound sample stuff ...
     mySound->load(in);
 
@@ -593,6 +605,8 @@ inline void TIA::endFrame()
   // Stats counters
   myFrameCounter++;
 
+  mySound->endFrame(mySystem->cycles());
+
   myFrameGreyed = false;
 }
 
@@ -1703,6 +1717,73 @@ inline void TIA::updateFrameScanline(uint32_t clocksToUpdate, uint32_t hpos)
   myFramePointer = ending;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Four bytes of an object mask, which may not be aligned
+static inline uint32_t maskWord(const uint8_t* mask)
+{
+  uint32_t word;
+  std::memcpy(&word, mask, sizeof(word));
+  return word;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void TIA::updateFrameCollisions(uint32_t clocksToUpdate, uint32_t hpos)
+{
+  // The same objects as the default case of updateFrameScanline, which the
+  // other cases agree with. Nothing changes when every collision the
+  // enabled objects could have is already latched, including when fewer
+  // than two are enabled.
+  uint8_t objects = myEnabledObjects;
+  uint16_t possible = ourCollisionTable[objects];
+  if(!(myVBLANK & 0x02) && (myCollision & possible) != possible)
+  {
+    uint32_t end = hpos + clocksToUpdate;
+    while(hpos < end)
+    {
+      // The playfield can't collide with itself, so skip four clocks at a
+      // time while none of the moving objects is drawn
+      uint32_t stop = std::min(hpos + 4, end);
+      if(stop == hpos + 4)
+      {
+        uint32_t drawn = 0;
+        if(objects & myP0Bit) drawn |= maskWord(&myCurrentP0Mask[hpos]);
+        if(objects & myP1Bit) drawn |= maskWord(&myCurrentP1Mask[hpos]);
+        if(objects & myM0Bit) drawn |= maskWord(&myCurrentM0Mask[hpos]);
+        if(objects & myM1Bit) drawn |= maskWord(&myCurrentM1Mask[hpos]);
+        if(objects & myBLBit) drawn |= maskWord(&myCurrentBLMask[hpos]);
+        if(drawn == 0)
+        {
+          hpos = stop;
+          continue;
+        }
+      }
+
+      for(; hpos < stop; ++hpos)
+      {
+        uint8_t enabled = (myPF & myCurrentPFMask[hpos]) ? myPFBit : 0;
+
+        if((objects & myBLBit) && myCurrentBLMask[hpos])
+          enabled |= myBLBit;
+
+        if(myCurrentGRP1 & myCurrentP1Mask[hpos])
+          enabled |= myP1Bit;
+
+        if((objects & myM1Bit) && myCurrentM1Mask[hpos])
+          enabled |= myM1Bit;
+
+        if(myCurrentGRP0 & myCurrentP0Mask[hpos])
+          enabled |= myP0Bit;
+
+        if((objects & myM0Bit) && myCurrentM0Mask[hpos])
+          enabled |= myM0Bit;
+
+        myCollision |= ourCollisionTable[enabled];
+      }
+    }
+  }
+  myFramePointer += clocksToUpdate;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::updateFrame(int clock)
 {
@@ -1768,7 +1849,10 @@ inline void TIA::updateFrame(int clock)
     // Update as much of the scanline as we can
     if(clocksToUpdate != 0)
     {
-      if (fastUpdate)
+      ALE_PERF_COUNT(mySystem->perfStats(), PERF_TIA_CLOCKS, clocksToUpdate);
+      if (!myRenderPixels)
+        updateFrameCollisions(clocksToUpdate, clocksFromStartOfScanLine - HBLANK);
+      else if (fastUpdate)
         updateFrameScanlineFast(clocksToUpdate, 
           clocksFromStartOfScanLine - HBLANK);
       else
@@ -1780,7 +1864,8 @@ inline void TIA::updateFrame(int clock)
         (clocksFromStartOfScanLine < (HBLANK + 8)))
     {
       int blanks = (HBLANK + 8) - clocksFromStartOfScanLine;
-      std::memset(oldFramePointer, 0, blanks);
+      if(myRenderPixels)
+        std::memset(oldFramePointer, 0, blanks);
 
       if((clocksToUpdate + clocksFromStartOfScanLine) >= (HBLANK + 8))
       {
@@ -1871,10 +1956,31 @@ void TIA::greyOutFrame()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearBuffers()
 {
-  for(uint32_t i = 0; i < 160 * 300; ++i)
-  {
-    myCurrentFrameBuffer[i] = myPreviousFrameBuffer[i] = 0;
-  }
+  std::memset(myCurrentFrameBuffer, 0, myFrameBufferSize);
+  std::memset(myPreviousFrameBuffer, 0, myFrameBufferSize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::resizeBuffers()
+{
+  // The display height may be overridden on the command line or switched
+  // to PAL by the console, and is clamped to at least 200 lines by
+  // frameReset(), so size the buffers for whichever is larger
+  uint32_t height = std::max(
+      atoi(myConsole.properties().get(Display_Height).c_str()), 200);
+
+  // Drawing stops at the end of the display, but the word-at-a-time
+  // loops in updateFrameScanline() may store up to three bytes past it,
+  // so keep a spare scanline at the end
+  uint32_t size = 160 * (height + 1);
+  if(size <= myFrameBufferSize)
+    return;
+
+  delete[] myCurrentFrameBuffer;
+  delete[] myPreviousFrameBuffer;
+  myCurrentFrameBuffer = new uint8_t[size];
+  myPreviousFrameBuffer = new uint8_t[size];
+  myFrameBufferSize = size;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
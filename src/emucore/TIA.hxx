@@ -156,6 +156,13 @@ class TIA : public Device , public MediaSource
     */
     uint8_t* previousFrameBuffer() const { return myPreviousFrameBuffer; }
 
+    /**
+      Answers the number of bytes allocated for each of the two frame buffers
+
+      @return The size of one frame buffer in bytes
+    */
+    uint32_t frameBufferSize() const { return myFrameBufferSize; }
+
     /**
       Answers the height of the frame buffer
 
@@ -259,6 +266,10 @@ class TIA : public Device , public MediaSource
     // Clear both internal TIA buffers to black (palette color 0)
     void clearBuffers();
 
+    // Make sure the frame buffers can hold the display height given by
+    // the console properties, reallocating them if necessary
+    void resizeBuffers();
+
     // Set up bookkeeping for the next frame
     void startFrame();
 
@@ -295,6 +306,9 @@ class TIA : public Device , public MediaSource
     // Pointer to the previous frame buffer
     uint8_t* myPreviousFrameBuffer;
 
+    // Number of bytes allocated for each frame buffer
+    uint32_t myFrameBufferSize;
+
     // Pointer to the next pixel that will be drawn in the current frame buffer
     uint8_t* myFramePointer;
 
@@ -546,6 +560,13 @@ class TIA : public Device , public MediaSource
     // Updates the frame's scanline but not the frame buffer 
     void updateFrameScanlineFast(uint32_t clocksToUpdate, uint32_t hpos);
 
+    // Whether pixels are written to the frame buffer; when they aren't
+    // (the ram_only setting) only collisions are computed
+    bool myRenderPixels;
+
+    // Computes the collisions of up to one scanline without drawing it
+    void updateFrameCollisions(uint32_t clocksToUpdate, uint32_t hpos);
+
 };
 
 }  // namespace stella
@@ -44,7 +44,7 @@ class ALEScreen {
   pixel_t* getRow(int r) const;
 
   /** Access the whole array */
-  pixel_t* getArray() const { return const_cast<pixel_t*>(&m_pixels[0]); }
+  pixel_t* getArray() const { return const_cast<pixel_t*>(m_pixels.data()); }
 
   /** Dimensionality information */
   size_t height() const { return m_rows; }
@@ -84,7 +84,7 @@ inline ALEScreen& ALEScreen::operator=(const ALEScreen& rhs) {
 
 inline bool ALEScreen::equals(const ALEScreen& rhs) const {
   return (m_rows == rhs.m_rows && m_columns == rhs.m_columns &&
-          (memcmp(&m_pixels[0], &rhs.m_pixels[0], arraySize()) == 0));
+          (memcmp(m_pixels.data(), rhs.m_pixels.data(), arraySize()) == 0));
 }
 
 // pixel accessors, (row, column)-ordered
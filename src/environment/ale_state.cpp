@@ -19,6 +19,7 @@
 
 #include "emucore/System.hxx"
 #include "emucore/Event.hxx"
+#include "emucore/Paddles.hxx"
 #include "emucore/Deserializer.hxx"
 #include "emucore/Serializer.hxx"
 #include "emucore/Random.hxx"
@@ -64,11 +65,11 @@ ALEState::ALEState(const std::string& serialized) {
 }
 
 /** Restores ALE to the given previously saved state. */
-void ALEState::load(OSystem* osystem, RomSettings* settings, Random* rng, std::string md5,
-                    const ALEState& rhs) {
+void ALEState::load(OSystem* osystem, RomSettings* settings, Random* rng,
+                    const std::string& md5, const ALEState& rhs) {
   assert(rhs.m_serialized_state.length() > 0);
 
-  // Deserialize the stored string into the emulator state
+  // Deserialize the stored string into the emulator state, in place
   Deserializer deser(rhs.m_serialized_state);
 
   osystem->console().system().loadState(md5, deser);
@@ -89,10 +90,10 @@ void ALEState::load(OSystem* osystem, RomSettings* settings, Random* rng, std::s
   m_difficulty = rhs.m_difficulty;
 }
 
-ALEState ALEState::save(OSystem* osystem, RomSettings* settings, std::optional<Random*> rng,
-                        std::string md5) {
+void ALEState::save(OSystem* osystem, RomSettings* settings, std::optional<Random*> rng,
+                    const std::string& md5, ALEState& out) const {
   // Use the emulator's built-in serialization to save the state
-  Serializer ser;
+  Serializer ser(out.m_serialized_state);
 
   osystem->console().system().saveState(md5, ser);
   settings->saveState(ser);
@@ -101,8 +102,15 @@ ALEState ALEState::save(OSystem* osystem, RomSettings* settings, std::optional<R
     rng.value()->saveState(ser);
   }
 
-  // Now make a copy of this state, also storing the emulator serialization
-  return ALEState(*this, ser.get_str());
+  // Now make a copy of everything else
+  out.m_left_paddle = m_left_paddle;
+  out.m_right_paddle = m_right_paddle;
+  out.m_paddle_min = m_paddle_min;
+  out.m_paddle_max = m_paddle_max;
+  out.m_frame_number = m_frame_number;
+  out.m_episode_frame_number = m_episode_frame_number;
+  out.m_mode = m_mode;
+  out.m_difficulty = m_difficulty;
 }
 
 void ALEState::incrementFrame(int steps /* = 1 */) {
@@ -128,75 +136,40 @@ std::string ALEState::serialize() {
   return ser.get_str();
 }
 
-/* ***************************************************************************
- *  Calculates the Paddle resistance, based on the given x val
- * ***************************************************************************/
-int ALEState::calcPaddleResistance(int x_val) {
-  return x_val; // this is different from the original stella implemebtation
-}
-
-void ALEState::resetPaddles(Event* event) {
+void ALEState::resetPaddles(Paddles* paddles) {
   int paddle_default = (m_paddle_min + m_paddle_max) / 2;
-  setPaddles(event, paddle_default, paddle_default);
+  setPaddles(paddles, paddle_default, paddle_default);
 }
 
-void ALEState::setPaddles(Event* event, int left, int right) {
+void ALEState::setPaddles(Paddles* paddles, int left, int right) {
   m_left_paddle = left;
   m_right_paddle = right;
+  setPaddleResistances(paddles);
+}
 
-  // Compute the "resistance" (this is for vestigal clarity)
-  int left_resistance = calcPaddleResistance(m_left_paddle);
-  int right_resistance = calcPaddleResistance(m_right_paddle);
-
-  // Update the events with the new resistances
-  event->set(Event::PaddleZeroResistance, left_resistance);
-  event->set(Event::PaddleOneResistance, right_resistance);
+void ALEState::setPaddleResistances(Paddles* paddles) {
+  // The resistance is the position itself, unlike in the original Stella
+  if (paddles != nullptr) {
+    paddles->setResistance(0, m_left_paddle);
+    paddles->setResistance(1, m_right_paddle);
+  }
 }
 
 void ALEState::setPaddleLimits(int paddle_min_val, int paddle_max_val) {
   m_paddle_min = paddle_min_val;
   m_paddle_max = paddle_max_val;
-  // Don't update paddle positions as this will send an event. Wait for next
-  // paddle update and the positions will be clamped to the new min/max.
+  // Don't update paddle positions here. Wait for next paddle update and the
+  // positions will be clamped to the new min/max.
 }
 
-/* *********************************************************************
- *  Updates the positions of the paddles, and sets an event for
- *  updating the corresponding paddle's resistance
- * ********************************************************************/
-void ALEState::updatePaddlePositions(Event* event, int delta_left,
-                                     int delta_right) {
-  // Cap paddle outputs
-
-  m_left_paddle += delta_left;
-  if (m_left_paddle < m_paddle_min) {
-    m_left_paddle = m_paddle_min;
-  }
-  if (m_left_paddle > m_paddle_max) {
-    m_left_paddle = m_paddle_max;
-  }
-
-  m_right_paddle += delta_right;
-  if (m_right_paddle < m_paddle_min) {
-    m_right_paddle = m_paddle_min;
-  }
-  if (m_right_paddle > m_paddle_max) {
-    m_right_paddle = m_paddle_max;
-  }
-
-  // Now set the paddle to their new value
-  setPaddles(event, m_left_paddle, m_right_paddle);
-}
-
-void ALEState::applyActionPaddles(Event* event, int player_a_action,
-                                  int player_b_action) {
+void ALEState::applyActionPaddles(Event* event, Paddles* paddles,
+                                  int player_a_action, int player_b_action,
+                                  int& delta_left, int& delta_right) {
   // Reset keys
   resetKeys(event);
 
   // First compute whether we should increase or decrease the paddle position
   //  (for both left and right players)
-  int delta_left;
-  int delta_right;
 
   switch (player_a_action) {
     case PLAYER_A_RIGHT:
@@ -244,14 +217,12 @@ void ALEState::applyActionPaddles(Event* event, int player_a_action,
       break;
   }
 
-  // Now update the paddle positions
-  updatePaddlePositions(event, delta_left, delta_right);
-
   // Handle reset
   if (player_a_action == RESET || player_b_action == RESET)
     event->set(Event::ConsoleReset, 1);
 
-  // Now add the fire event
+  // Now press or release the fire buttons
+  bool fire_left;
   switch (player_a_action) {
     case PLAYER_A_FIRE:
     case PLAYER_A_UPFIRE:
@@ -262,13 +233,14 @@ void ALEState::applyActionPaddles(Event* event, int player_a_action,
     case PLAYER_A_UPLEFTFIRE:
     case PLAYER_A_DOWNRIGHTFIRE:
     case PLAYER_A_DOWNLEFTFIRE:
-      event->set(Event::PaddleZeroFire, 1);
+      fire_left = true;
       break;
     default:
-      // Nothing
+      fire_left = false;
       break;
   }
 
+  bool fire_right;
   switch (player_b_action) {
     case PLAYER_B_FIRE:
     case PLAYER_B_UPFIRE:
@@ -279,12 +251,17 @@ void ALEState::applyActionPaddles(Event* event, int player_a_action,
     case PLAYER_B_UPLEFTFIRE:
     case PLAYER_B_DOWNRIGHTFIRE:
     case PLAYER_B_DOWNLEFTFIRE:
-      event->set(Event::PaddleOneFire, 1);
+      fire_right = true;
       break;
     default:
-      // Nothing
+      fire_right = false;
       break;
   }
+
+  if (paddles != nullptr) {
+    paddles->setFire(0, fire_left);
+    paddles->setFire(1, fire_right);
+  }
 }
 
 void ALEState::pressSelect(Event* event) {
@@ -516,10 +493,6 @@ void ALEState::resetKeys(Event* event) {
   event->set(Event::JoystickOneRight, 0);
   event->set(Event::JoystickOneLeft, 0);
 
-  // also reset paddle fire
-  event->set(Event::PaddleZeroFire, 0);
-  event->set(Event::PaddleOneFire, 0);
-
   // Set the difficulty switches accordingly for this time step.
   setDifficultySwitches(event, m_difficulty);
 }
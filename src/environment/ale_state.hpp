@@ -18,6 +18,7 @@
 #ifndef __ALE_STATE_HPP__
 #define __ALE_STATE_HPP__
 
+#include <algorithm>
 #include <string>
 #include <optional>
 
@@ -28,6 +29,9 @@
 #include "common/Log.hpp"
 
 namespace ale {
+namespace stella {
+class Paddles;
+}  // namespace stella
 
 class RomSettings;
 
@@ -55,15 +59,25 @@ class ALEState {
   /** Returns true if the two states contain the same saved information */
   bool equals(ALEState& state);
 
-  void resetPaddles(stella::Event*);
+  /** Centers the paddles plugged into the left jack, if any */
+  void resetPaddles(stella::Paddles* paddles);
 
   //Apply the special select action
   void pressSelect(stella::Event* event_obj);
 
-  /** Applies paddle actions. This actually modifies the game state by updating the paddle
-      *  resistances. */
-  void applyActionPaddles(stella::Event* event_obj, int player_a_action,
-                          int player_b_action);
+  /** Applies paddle actions: presses the fire buttons and RESET, and returns how far
+   *  the action moves each paddle per frame, which updatePaddlePositions() applies
+   *  before each emulated frame. */
+  void applyActionPaddles(stella::Event* event_obj, stella::Paddles* paddles,
+                          int player_a_action, int player_b_action,
+                          int& delta_left, int& delta_right);
+
+  /** Updates the paddle positions by a delta amount, keeping them within the limits. */
+  void updatePaddlePositions(stella::Paddles* paddles, int delta_left, int delta_right) {
+    m_left_paddle = std::min(std::max(m_left_paddle + delta_left, m_paddle_min), m_paddle_max);
+    m_right_paddle = std::min(std::max(m_right_paddle + delta_right, m_paddle_min), m_paddle_max);
+    setPaddleResistances(paddles);
+  }
   /** Sets the joystick events. No effect until the emulator is run forward. */
   void setActionJoysticks(stella::Event* event_obj, int player_a_action,
                           int player_b_action);
@@ -101,27 +115,27 @@ class ALEState {
 
   // The two methods below are meant to be used by StellaEnvironment.
   // Restores the environment to a previously saved state.
-  void load(stella::OSystem* osystem, RomSettings* settings, stella::Random* rng, std::string md5,
-            const ALEState& rhs);
+  void load(stella::OSystem* osystem, RomSettings* settings, stella::Random* rng,
+            const std::string& md5, const ALEState& rhs);
 
-  /** Returns a "copy" of the current state, including the information necessary to restore
-   *  the emulator. The RNG can optionally be included in the state. */
-  ALEState save(stella::OSystem* osystem, RomSettings* settings, std::optional<stella::Random*> rng, std::string md5);
+  /** Stores a "copy" of the current state in `out`, including the information necessary to
+   *  restore the emulator. The RNG can optionally be included in the state. The emulator is
+   *  serialized straight into out's buffer, reusing its capacity. */
+  void save(stella::OSystem* osystem, RomSettings* settings, std::optional<stella::Random*> rng,
+            const std::string& md5, ALEState& out) const;
 
   /** Reset key presses */
   void resetKeys(stella::Event* event_obj);
 
   /** Sets the paddle to a given position */
-  void setPaddles(stella::Event* event_obj, int left, int right);
+  void setPaddles(stella::Paddles* paddles, int left, int right);
 
   /** Set the paddle min/max values */
   void setPaddleLimits(int paddle_min_val, int paddle_max_val);
 
-  /** Updates the paddle position by a delta amount. */
-  void updatePaddlePositions(stella::Event* event_obj, int delta_x, int delta_y);
-
-  /** Calculates the Paddle resistance, based on the given x val */
-  int calcPaddleResistance(int x_val);
+  /** Hands the paddle positions to the paddles, which may be null if the
+   *  game's paddles aren't plugged into the left jack */
+  void setPaddleResistances(stella::Paddles* paddles);
 
   /** Applies the current difficulty setting, which is effectively part of the action */
   void setDifficultySwitches(stella::Event* event_obj, unsigned int value);
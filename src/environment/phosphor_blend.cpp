@@ -16,16 +16,43 @@
 
 #include "environment/phosphor_blend.hpp"
 
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include "emucore/Console.hxx"
 
 namespace ale {
 using namespace stella;   // OSystem
 
-PhosphorBlend::PhosphorBlend(OSystem* osystem) : m_osystem(osystem) {
-  // Taken from default Stella settings
-  m_phosphor_blend_ratio = 77;
+// Taken from default Stella settings
+static const uint8_t phosphor_blend_ratio = 77;
+
+PhosphorBlend::PhosphorBlend(OSystem* osystem)
+    : m_osystem(osystem),
+      m_tables(sharedTables(osystem->colourPalette())) {}
 
-  makeAveragePalette();
+std::shared_ptr<const PhosphorBlend::Tables>
+PhosphorBlend::sharedTables(const ColourPalette& palette) {
+  // Tables are keyed on the palette contents and only kept alive by the
+  // instances using them
+  static std::mutex cache_mutex;
+  static std::map<std::vector<uint32_t>, std::weak_ptr<const Tables>> cache;
+
+  std::vector<uint32_t> key(256);
+  for (int c = 0; c < 256; c++) {
+    key[c] = palette.getRGB(c);
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  std::shared_ptr<const Tables> tables = cache[key].lock();
+  if (!tables) {
+    std::shared_ptr<Tables> fresh = std::make_shared<Tables>();
+    makeAveragePalette(palette, *fresh);
+    tables = fresh;
+    cache[key] = tables;
+  }
+  return tables;
 }
 
 void PhosphorBlend::process(ALEScreen& screen) {
@@ -41,15 +68,14 @@ void PhosphorBlend::process(ALEScreen& screen) {
     int pv = previous_buffer[i];
 
     // Find out the corresponding rgb color
-    uint32_t rgb = m_avg_palette[cv][pv];
+    uint32_t rgb = m_tables->avg_palette[cv][pv];
 
     // Set the corresponding pixel in the array
     screen.getArray()[i] = rgbToNTSC(rgb);
   }
 }
-void PhosphorBlend::makeAveragePalette() {
-  ColourPalette& palette = m_osystem->colourPalette();
-
+void PhosphorBlend::makeAveragePalette(const ColourPalette& palette,
+                                       Tables& tables) {
   // Precompute the average RGB values for phosphor-averaged colors c1 and c2.
   for (int c1 = 0; c1 < 256; c1 += 2) {
     for (int c2 = 0; c2 < 256; c2 += 2) {
@@ -61,7 +87,7 @@ void PhosphorBlend::makeAveragePalette() {
       uint8_t r = getPhosphor(r1, r2);
       uint8_t g = getPhosphor(g1, g2);
       uint8_t b = getPhosphor(b1, b2);
-      m_avg_palette[c1][c2] = makeRGB(r, g, b);
+      tables.avg_palette[c1][c2] = makeRGB(r, g, b);
     }
   }
 
@@ -88,7 +114,7 @@ void PhosphorBlend::makeAveragePalette() {
           }
         }
 
-        m_rgb_ntsc[r >> 2][g >> 2][b >> 2] = minIndex;
+        tables.rgb_ntsc[r >> 2][g >> 2][b >> 2] = minIndex;
       }
     }
   }
@@ -101,7 +127,7 @@ uint8_t PhosphorBlend::getPhosphor(uint8_t v1, uint8_t v2) {
     v2 = tmp;
   }
 
-  uint32_t blendedValue = ((v1 - v2) * m_phosphor_blend_ratio) / 100 + v2;
+  uint32_t blendedValue = ((v1 - v2) * phosphor_blend_ratio) / 100 + v2;
   if (blendedValue > 255)
     return 255;
   else
@@ -113,12 +139,12 @@ uint32_t PhosphorBlend::makeRGB(uint8_t r, uint8_t g, uint8_t b) {
 }
 
 /** Converts a RGB value to an 8-bit format */
-uint8_t PhosphorBlend::rgbToNTSC(uint32_t rgb) {
+uint8_t PhosphorBlend::rgbToNTSC(uint32_t rgb) const {
   int r = (rgb >> 16) & 0xFF;
   int g = (rgb >> 8) & 0xFF;
   int b = rgb & 0xFF;
 
-  return m_rgb_ntsc[r >> 2][g >> 2][b >> 2];
+  return m_tables->rgb_ntsc[r >> 2][g >> 2][b >> 2];
 }
 
 }  // namespace ale
@@ -17,6 +17,9 @@
 #ifndef __PHOSPHOR_BLEND_HPP__
 #define __PHOSPHOR_BLEND_HPP__
 
+#include <cstddef>
+#include <memory>
+
 #include "emucore/OSystem.hxx"
 #include "environment/ale_screen.hpp"
 
@@ -28,20 +31,28 @@ class PhosphorBlend {
 
   void process(ALEScreen& screen);
 
+  /** Bytes held by the lookup tables. These are immutable and shared between
+   *  all instances using the same palette, so are not owned by any one. */
+  static size_t sharedTableSize() { return sizeof(Tables); }
+
  private:
-  void makeAveragePalette();
-  uint8_t getPhosphor(uint8_t v1, uint8_t v2);
-  uint32_t makeRGB(uint8_t r, uint8_t g, uint8_t b);
+  struct Tables {
+    uint8_t rgb_ntsc[64][64][64];
+    uint32_t avg_palette[256][256];
+  };
+
+  /** Returns the tables for the given palette, building them on first use */
+  static std::shared_ptr<const Tables> sharedTables(const ColourPalette& palette);
+  static void makeAveragePalette(const ColourPalette& palette, Tables& tables);
+  static uint8_t getPhosphor(uint8_t v1, uint8_t v2);
+  static uint32_t makeRGB(uint8_t r, uint8_t g, uint8_t b);
   /** Converts a RGB value to an 8-bit format */
-  uint8_t rgbToNTSC(uint32_t rgb);
+  uint8_t rgbToNTSC(uint32_t rgb) const;
 
  private:
   stella::OSystem* m_osystem;
 
-  uint8_t m_rgb_ntsc[64][64][64];
-
-  uint32_t m_avg_palette[256][256];
-  uint8_t m_phosphor_blend_ratio;
+  std::shared_ptr<const Tables> m_tables;
 };
 
 }  // namespace ale
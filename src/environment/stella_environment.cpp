@@ -17,32 +17,66 @@
 
 #include "environment/stella_environment.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <sstream>
 #include <cstring>
 #include <optional>
+#include <stdexcept>
 
+#include "emucore/M6532.hxx"
+#include "emucore/Paddles.hxx"
 #include "emucore/System.hxx"
+#include "common/Trace.hpp"
 
 namespace ale {
-using namespace stella;   // OSystem, Random
+using namespace stella;   // OSystem, Random, Controller, Paddles
+
+// Tells environments apart in traces, see common/Trace.hpp
+static uint32_t nextTraceId() {
+  static std::atomic<uint32_t> next_id(0);
+  return next_id++;
+}
+
+// Agents that only read the RAM get an empty screen
+static ALEScreen makeScreen(OSystem* osystem) {
+  if (osystem->settings().getBool(Setting_RamOnly)) {
+    return ALEScreen(0, 0);
+  }
+  return ALEScreen(osystem->console().mediaSource().height(),
+                   osystem->console().mediaSource().width());
+}
 
 StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings)
     : m_osystem(osystem),
       m_settings(settings),
-      m_phosphor_blend(osystem),
-      m_screen(m_osystem->console().mediaSource().height(),
-               m_osystem->console().mediaSource().width()),
+      m_screen(makeScreen(osystem)),
+      m_paddles(nullptr),
+      m_suppress_observations(false),
+      m_defer_settings_step(false),
+      m_trace_id(nextTraceId()),
+      m_state_size(0),
       m_player_a_action(PLAYER_A_NOOP),
       m_player_b_action(PLAYER_B_NOOP) {
   // Determine whether this is a paddle-based game
   if (m_osystem->console().properties().get(Controller_Left) == "PADDLES" ||
       m_osystem->console().properties().get(Controller_Right) == "PADDLES") {
     m_use_paddles = true;
-    int paddle_min_val = m_osystem->settings().getInt("paddle_min");
-    int paddle_max_val = m_osystem->settings().getInt("paddle_max");
+    // Actions drive the paddles plugged into the left jack, which may be in
+    // either port
+    for (Controller::Jack port : {Controller::Left, Controller::Right}) {
+      Controller& controller = m_osystem->console().controller(port);
+      if (controller.type() == Controller::Paddles &&
+          controller.jack() == Controller::Left) {
+        m_paddles = static_cast<Paddles*>(&controller);
+      }
+    }
+    int paddle_min_val = m_osystem->settings().getInt(Setting_PaddleMin);
+    int paddle_max_val = m_osystem->settings().getInt(Setting_PaddleMax);
     m_state.setPaddleLimits(paddle_min_val != -1 ? paddle_min_val : PADDLE_MIN,
                             paddle_max_val != -1 ? paddle_max_val : PADDLE_MAX);
-    m_state.resetPaddles(m_osystem->event());
+    m_state.resetPaddles(m_paddles);
   } else {
     m_use_paddles = false;
   }
@@ -50,12 +84,13 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings)
   m_cartridge_md5 = m_osystem->console().properties().get(Cartridge_MD5);
 
   // Initialize RNG
+  m_random.setGenerator(m_osystem->settings().getString(Setting_Rng));
   int32_t seed;
-  if (m_osystem->settings().getInt("random_seed") == -1) {
+  if (m_osystem->settings().getInt(Setting_RandomSeed) == -1) {
     seed = time(NULL);
     m_random.seed((uint32_t)seed);
   } else {
-    seed = m_osystem->settings().getInt("random_seed");
+    seed = m_osystem->settings().getInt(Setting_RandomSeed);
     assert(seed >= 0);
     m_random.seed((uint32_t)seed);
   }
@@ -65,20 +100,51 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings)
   m_state.setCurrentMode(settings->getDefaultMode());
 
   m_max_num_frames_per_episode =
-      m_osystem->settings().getInt("max_num_frames_per_episode");
-  m_colour_averaging = m_osystem->settings().getBool("color_averaging");
+      m_osystem->settings().getInt(Setting_MaxNumFramesPerEpisode);
+  m_ram_only = m_osystem->settings().getBool(Setting_RamOnly);
+  m_colour_averaging = m_osystem->settings().getBool(Setting_ColorAveraging);
+  if (m_colour_averaging && m_ram_only) {
+    Logger::Warning << "Warning: no screen to average with ram_only set. "
+                    << "Ignoring color_averaging.\n";
+    m_colour_averaging = false;
+  }
+  if (m_colour_averaging) {
+    m_phosphor_blend.reset(new PhosphorBlend(m_osystem));
+  }
 
   m_repeat_action_probability =
-      m_osystem->settings().getFloat("repeat_action_probability");
-
-  m_frame_skip = m_osystem->settings().getInt("frame_skip");
-  if (m_frame_skip < 1) {
+      m_osystem->settings().getFloat(Setting_RepeatActionProbability);
+  // The action is repeated when next() / 2^32 < p, i.e. next() < ceil(p 2^32)
+  m_sticky_threshold = (uint64_t)std::ceil(
+      std::min(std::max((double)m_repeat_action_probability, 0.0), 1.0) *
+      4294967296.0);
+
+  int frame_skip = m_osystem->settings().getInt(Setting_FrameSkip);
+  if (frame_skip < 1) {
     Logger::Warning << "Warning: frame skip set to < 1. Setting to 1.\n";
-    m_frame_skip = 1;
+    frame_skip = 1;
   }
+  m_frame_skip = frame_skip;
+  int frame_skip_max = m_osystem->settings().getInt(Setting_FrameSkipMax);
+  m_frame_skip_max = std::max(frame_skip_max, frame_skip);
+  m_step_at_skip_boundaries = m_settings->stepsAtSkipBoundaries();
+
+  m_noop_max = m_osystem->settings().getInt(Setting_NoopMax);
+  if (m_noop_max < 0) {
+    Logger::Warning << "Warning: noop_max set to < 0. Setting to 0.\n";
+    m_noop_max = 0;
+  }
+  m_cache_resets = m_osystem->settings().getBool(Setting_CacheResets);
 
   // If so desired, we record all emulated frames to a given directory
-  std::string recordDir = m_osystem->settings().getString("record_screen_dir");
+  std::string recordDir = m_osystem->settings().getString(Setting_RecordScreenDir);
+  std::string recordFile = m_osystem->settings().getString(Setting_RecordScreenFile);
+  if (m_ram_only && (!recordDir.empty() || !recordFile.empty())) {
+    Logger::Warning << "Warning: no screen to record with ram_only set. "
+                    << "Ignoring screen recording.\n";
+    recordDir.clear();
+    recordFile.clear();
+  }
   if (!recordDir.empty()) {
     Logger::Info << "Recording screens to directory: " << recordDir << "\n";
 
@@ -86,46 +152,134 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings)
     m_screen_exporter.reset(
         new ScreenExporter(m_osystem->colourPalette(), recordDir));
   }
+
+  // Or stream them to a single file, encoded in the background
+  if (!recordFile.empty()) {
+    Logger::Info << "Recording screens to file: " << recordFile << "\n";
+
+    m_screen_recorder.reset(
+        new ScreenRecorder(m_osystem->colourPalette(), recordFile,
+                           m_screen.height(), m_screen.width()));
+  }
 }
 
 /** Resets the system to its start state. */
 void StellaEnvironment::reset() {
-  m_state.resetEpisodeFrameNumber();
-  // Reset the paddles
-  m_state.resetPaddles(m_osystem->event());
+  TraceScope trace("reset", m_trace_id);
+
+  // The start is drawn even when it's cached, so the sticky actions that
+  // follow don't depend on the cache
+  int start = -1;
+  if (!m_start_states.empty()) {
+    start = ((uint64_t)m_random.next() * m_start_states.size()) >> 32;
+  }
+  int noops = 0;
+  if (m_noop_max > 0) {
+    noops = 1 + (int)(((uint64_t)m_random.next() * m_noop_max) >> 32);
+  }
+
+  if (!m_cache_resets) {
+    emulateReset(start, noops);
+    return;
+  }
+
+  ResetKey key(getMode(), getDifficulty(), start, noops);
+  auto cached = m_reset_cache.find(key);
+  if (cached == m_reset_cache.end()) {
+    emulateReset(start, noops);
+    ALEState state;
+    cloneState(state);
+    m_reset_cache.emplace(key, ResetCacheEntry{std::move(state), m_screen});
+    return;
+  }
+
+  // The cached state holds the frames of its own episode; the total keeps
+  // counting from ours
+  int frame_number = m_state.getFrameNumber();
+  restoreState(cached->second.state);
+  m_state.m_frame_number = frame_number + m_state.getEpisodeFrameNumber();
+  m_player_a_action = PLAYER_A_NOOP;
+  m_player_b_action = PLAYER_B_NOOP;
+  m_screen = cached->second.screen;
+  processRAM();
+}
+
+void StellaEnvironment::emulateReset(int start, int noops) {
+  // Only the observations at the end of the reset are processed
+  bool suppress_observations = m_suppress_observations;
+  m_suppress_observations = true;
+
+  if (start >= 0) {
+    // A start state replaces the whole reset, but not the total frame count
+    int frame_number = m_state.getFrameNumber();
+    restoreState(m_start_states[start]);
+    m_state.m_frame_number = frame_number;
+    m_state.resetEpisodeFrameNumber();
+    m_player_a_action = PLAYER_A_NOOP;
+    m_player_b_action = PLAYER_B_NOOP;
+  } else {
+    m_state.resetEpisodeFrameNumber();
+    // Reset the paddles
+    m_state.resetPaddles(m_paddles);
 
-  // Reset the emulator
-  m_osystem->console().system().reset();
+    // Reset the emulator
+    m_osystem->console().system().reset();
 
-  // NOOP for 60 steps in the deterministic environment setting, or some random amount otherwise
-  int noopSteps;
-  noopSteps = 60;
+    // NOOP for 60 steps in the deterministic environment setting, or some random amount otherwise
+    int noopSteps;
+    noopSteps = 60;
 
-  emulate(PLAYER_A_NOOP, PLAYER_B_NOOP, noopSteps);
-  // Reset the emulator
-  softReset();
+    emulate(PLAYER_A_NOOP, PLAYER_B_NOOP, noopSteps);
+    // Reset the emulator
+    softReset();
 
-  // reset the rom (after emulating, in case the NOOPs led to reward)
-  m_settings->reset();
+    // reset the rom (after emulating, in case the NOOPs led to reward)
+    m_settings->reset();
 
-  // Apply mode that was previously defined, then soft reset with this mode
-  m_settings->setMode(m_state.getCurrentMode(), m_osystem->console().system(),
-                      getWrapper());
-  softReset();
+    // Apply mode that was previously defined, then soft reset with this mode
+    m_settings->setMode(m_state.getCurrentMode(), m_osystem->console().system(),
+                        getWrapper());
+    softReset();
 
-  // Apply necessary actions specified by the rom itself
-  ActionVect startingActions = m_settings->getStartingActions();
-  for (size_t i = 0; i < startingActions.size(); i++) {
-    emulate(startingActions[i], PLAYER_B_NOOP);
+    // Apply necessary actions specified by the rom itself
+    ActionVect startingActions = m_settings->getStartingActions();
+    for (size_t i = 0; i < startingActions.size(); i++) {
+      emulate(startingActions[i], PLAYER_B_NOOP);
+    }
+  }
+
+  for (int i = 0; i < noops && !isTerminal(); i++) {
+    oneStepAct(PLAYER_A_NOOP, PLAYER_B_NOOP, NULL);
   }
+
+  m_suppress_observations = suppress_observations;
+  processScreen();
+  processRAM();
+}
+
+void StellaEnvironment::setStartStates(
+    const std::vector<ALEState>& start_states) {
+  m_start_states = start_states;
+  m_reset_cache.clear();
 }
 
 ALEState StellaEnvironment::cloneState(bool include_rng) {
+  ALEState state;
+  cloneState(state, include_rng);
+  return state;
+}
+
+void StellaEnvironment::cloneState(ALEState& out, bool include_rng) {
+  TraceScope trace("cloneState", m_trace_id);
+  // States rarely change size, so this usually allocates at most once
+  out.m_serialized_state.reserve(m_state_size);
   std::optional<Random*> rng = include_rng ? std::make_optional(&m_random) : std::nullopt;
-  return m_state.save(m_osystem, m_settings, rng, m_cartridge_md5);
+  m_state.save(m_osystem, m_settings, rng, m_cartridge_md5, out);
+  m_state_size = out.m_serialized_state.size();
 }
 
 void StellaEnvironment::restoreState(const ALEState& target_state) {
+  TraceScope trace("restoreState", m_trace_id);
   m_state.load(m_osystem, m_settings, &m_random, m_cartridge_md5, target_state);
 }
 
@@ -147,20 +301,42 @@ void StellaEnvironment::noopIllegalActions(Action& player_a_action,
 }
 
 reward_t StellaEnvironment::act(Action player_a_action,
-                                Action player_b_action) {
+                                Action player_b_action,
+                                reward_t* player_b_reward) {
+  TraceScope trace("act", m_trace_id);
+
   // Total reward received as we repeat the action
   reward_t sum_rewards = 0;
-
-  Random& rng = getEnvironmentRNG();
-
-  // Apply the same action for a given number of times... note that act() will refuse to emulate
-  //  past the terminal state
-  for (size_t i = 0; i < m_frame_skip; i++) {
+  if (player_b_reward != NULL)
+    *player_b_reward = 0;
+
+  // Player B is off while it does nothing, and sticky actions can't change that
+  bool player_b_active = player_b_action != PLAYER_B_NOOP ||
+                         m_player_b_action != PLAYER_B_NOOP;
+
+  // The number of frames is drawn first, on its own, if frame skip is
+  // stochastic. The rest of this step's random numbers are then drawn in one
+  // block: for each frame, whether player A's and, if it's active, player
+  // B's action is dropped
+  size_t num_frames = m_frame_skip;
+  if (m_frame_skip_max > m_frame_skip) {
+    num_frames += ((uint64_t)m_random.next() *
+                   (m_frame_skip_max - m_frame_skip + 1)) >> 32;
+  }
+  size_t draws_per_frame =
+      m_sticky_threshold == 0 ? 0 : (player_b_active ? 2 : 1);
+  m_draws.resize(num_frames * draws_per_frame);
+  m_random.nextBlock(m_draws.data(), m_draws.size());
+  const uint32_t* draw = m_draws.data();
+
+  // Apply the same action for a given number of times, stopping as soon as
+  // the episode ends. All the random numbers were drawn above, so where it
+  // ends doesn't change those of later steps.
+  for (size_t i = 0; i < num_frames && !isTerminal(); i++) {
     // Stochastically drop actions, according to m_repeat_action_probability
-    if (rng.nextDouble() >= m_repeat_action_probability)
+    if (draws_per_frame == 0 || *draw++ >= m_sticky_threshold)
       m_player_a_action = player_a_action;
-    // @todo Possibly optimize by avoiding call to rand() when player B is "off" ?
-    if (rng.nextDouble() >= m_repeat_action_probability)
+    if (draws_per_frame < 2 || *draw++ >= m_sticky_threshold)
       m_player_b_action = player_b_action;
 
     // If so desired, request one frame's worth of sound (this does nothing if recording
@@ -171,18 +347,111 @@ reward_t StellaEnvironment::act(Action player_a_action,
     m_osystem->screen().render();
 
     // Similarly record screen as needed
-    if (m_screen_exporter.get() != NULL)
+    if (m_screen_exporter.get() != NULL) {
+      TraceScope trace("saveScreen", m_trace_id);
       m_screen_exporter->saveNext(m_screen);
+    }
+    if (m_screen_recorder.get() != NULL) {
+      TraceScope trace("recordScreen", m_trace_id);
+      m_screen_recorder->record(m_screen);
+    }
+
+    // Games that allow it are only stepped on the last frame, and their
+    // reward then covers all of them
+    m_defer_settings_step = m_step_at_skip_boundaries && i + 1 < num_frames;
 
     // Use the stored actions, which may or may not have changed this frame
-    sum_rewards += oneStepAct(m_player_a_action, m_player_b_action);
+    sum_rewards += oneStepAct(m_player_a_action, m_player_b_action,
+                              player_b_reward);
+  }
+
+  // The frame limit ended the episode before the last frame
+  if (m_defer_settings_step) {
+    m_defer_settings_step = false;
+    stepSettings();
+    sum_rewards += m_settings->getReward();
+    if (player_b_reward != NULL)
+      *player_b_reward += m_settings->getRewardPlayerB();
   }
 
   return sum_rewards;
 }
 
+reward_t StellaEnvironment::actContinuous(float paddle_position, bool fire) {
+  if (!m_use_paddles) {
+    throw std::runtime_error("This game doesn't use paddles");
+  }
+  setPaddlePosition(paddle_position);
+  return act(fire ? PLAYER_A_FIRE : PLAYER_A_NOOP, PLAYER_B_NOOP);
+}
+
+void StellaEnvironment::setPaddlePosition(float paddle_position) {
+  // High resistances are on the left
+  float x = paddle_position > 0.0f ? std::min(paddle_position, 1.0f) : 0.0f;
+  int left = (int)std::lround(m_state.m_paddle_max -
+                              x * (m_state.m_paddle_max - m_state.m_paddle_min));
+  m_state.setPaddles(m_paddles, left, m_state.m_right_paddle);
+}
+
+size_t StellaEnvironment::actSequence(const Action* actions, size_t n,
+                                      reward_t* rewards_out,
+                                      bool stop_on_terminal,
+                                      bool suppress_observations,
+                                      const Action* player_b_actions,
+                                      reward_t* player_b_rewards_out,
+                                      const float* paddle_positions) {
+  if (paddle_positions != NULL && !m_use_paddles) {
+    throw std::runtime_error("This game doesn't use paddles");
+  }
+
+  // Recorded frames need every observation
+  m_suppress_observations = suppress_observations &&
+                            m_screen_exporter.get() == NULL &&
+                            m_screen_recorder.get() == NULL;
+
+  size_t terminal_index = n;
+  size_t i = 0;
+  for (; i < n; i++) {
+    Action player_b_action =
+        player_b_actions != NULL ? player_b_actions[i] : PLAYER_B_NOOP;
+    if (paddle_positions != NULL)
+      setPaddlePosition(paddle_positions[i]);
+    reward_t player_b_reward = 0;
+    reward_t reward = act(actions[i], player_b_action,
+                          player_b_rewards_out != NULL ? &player_b_reward : NULL);
+    if (rewards_out != NULL)
+      rewards_out[i] = reward;
+    if (player_b_rewards_out != NULL)
+      player_b_rewards_out[i] = player_b_reward;
+
+    if (terminal_index == n && isTerminal()) {
+      terminal_index = i;
+      if (stop_on_terminal) {
+        i++;
+        break;
+      }
+    }
+  }
+
+  if (rewards_out != NULL) {
+    std::fill(rewards_out + i, rewards_out + n, 0);
+  }
+  if (player_b_rewards_out != NULL) {
+    std::fill(player_b_rewards_out + i, player_b_rewards_out + n, 0);
+  }
+
+  if (m_suppress_observations) {
+    m_suppress_observations = false;
+    processScreen();
+    processRAM();
+  }
+
+  return terminal_index;
+}
+
 /** This functions emulates a push on the reset button of the console */
 void StellaEnvironment::softReset() {
+  TraceScope trace("softReset", m_trace_id);
   emulate(RESET, PLAYER_B_NOOP, m_num_reset_steps);
 
   // Reset previous actions to NOOP for correct action repeating
@@ -193,7 +462,8 @@ void StellaEnvironment::softReset() {
 /** Applies the given actions (e.g. updating paddle positions when the paddle is used)
  *  and performs one simulation step in Stella. */
 reward_t StellaEnvironment::oneStepAct(Action player_a_action,
-                                       Action player_b_action) {
+                                       Action player_b_action,
+                                       reward_t* player_b_reward) {
   // Once in a terminal state, refuse to go any further (special actions must be handled
   //  outside of this environment; in particular reset() should be called rather than passing
   //  RESET or SYSTEM_RESET.
@@ -208,6 +478,10 @@ reward_t StellaEnvironment::oneStepAct(Action player_a_action,
   // Increment the number of frames seen so far
   m_state.incrementFrame();
 
+  if (m_defer_settings_step)
+    return 0;
+  if (player_b_reward != NULL)
+    *player_b_reward += m_settings->getRewardPlayerB();
   return m_settings->getReward();
 }
 
@@ -238,17 +512,23 @@ void StellaEnvironment::setMode(game_mode_t value) {
 
 void StellaEnvironment::emulate(Action player_a_action, Action player_b_action,
                                 size_t num_steps) {
+  TraceScope trace("emulate", m_trace_id);
   Event* event = m_osystem->event();
 
   // Handle paddles separately: we have to manually update the paddle positions at each step
   if (m_use_paddles) {
+    // The action is decoded once; each step then only moves the paddles
+    int delta_left, delta_right;
+    m_state.applyActionPaddles(event, m_paddles, player_a_action,
+                               player_b_action, delta_left, delta_right);
+
     // Run emulator forward for 'num_steps'
     for (size_t t = 0; t < num_steps; t++) {
       // Update paddle position at every step
-      m_state.applyActionPaddles(event, player_a_action, player_b_action);
+      m_state.updatePaddlePositions(m_paddles, delta_left, delta_right);
 
       m_osystem->console().mediaSource().update();
-      m_settings->step(m_osystem->console().system());
+      stepSettings();
     }
   } else {
     // In joystick mode we only need to set the action events once
@@ -256,13 +536,15 @@ void StellaEnvironment::emulate(Action player_a_action, Action player_b_action,
 
     for (size_t t = 0; t < num_steps; t++) {
       m_osystem->console().mediaSource().update();
-      m_settings->step(m_osystem->console().system());
+      stepSettings();
     }
   }
 
   // Parse screen and RAM into their respective data structures
-  processScreen();
-  processRAM();
+  if (!m_suppress_observations) {
+    processScreen();
+    processRAM();
+  }
 }
 
 /** Accessor methods for the environment state. */
@@ -275,10 +557,37 @@ std::unique_ptr<StellaEnvironmentWrapper> StellaEnvironment::getWrapper() {
       new StellaEnvironmentWrapper(*this));
 }
 
+void StellaEnvironment::memoryFootprint(
+    std::map<std::string, size_t>& footprint) const {
+  footprint["environment"] = sizeof(StellaEnvironment) +
+                             m_cartridge_md5.capacity();
+  footprint["screen"] = m_screen.arraySize();
+  size_t reset_cache = 0;
+  for (const auto& entry : m_reset_cache) {
+    reset_cache += entry.second.state.m_serialized_state.capacity() +
+                   entry.second.screen.arraySize();
+  }
+  footprint["reset_cache"] = reset_cache;
+  footprint["phosphor_blend"] = m_phosphor_blend ? sizeof(PhosphorBlend) : 0;
+  footprint["shared"] =
+      m_phosphor_blend ? PhosphorBlend::sharedTableSize() : 0;
+}
+
+void StellaEnvironment::stepSettings() {
+  if (m_defer_settings_step)
+    return;
+  System& system = m_osystem->console().system();
+  ALE_PERF_TIME(system.perfStats(), PERF_ROM_STEP);
+  m_settings->step(system);
+}
+
 void StellaEnvironment::processScreen() {
-  if (m_colour_averaging) {
+  ALE_PERF_TIME(m_osystem->console().system().perfStats(), PERF_PROCESS_SCREEN);
+  if (m_ram_only) {
+    return;
+  } else if (m_colour_averaging) {
     // Perform phosphor averaging; the blender stores its result in the given screen
-    m_phosphor_blend.process(m_screen);
+    m_phosphor_blend->process(m_screen);
   } else {
     // Copy screen over and we're done!
     std::memcpy(m_screen.getArray(),
@@ -288,9 +597,10 @@ void StellaEnvironment::processScreen() {
 }
 
 void StellaEnvironment::processRAM() {
-  // Copy RAM over
-  for (size_t i = 0; i < m_ram.size(); i++)
-    *m_ram.byte(i) = m_osystem->console().system().peek(i + 0x80);
+  ALE_PERF_TIME(m_osystem->console().system().perfStats(), PERF_PROCESS_RAM);
+  // Copy RAM over, straight from the RIOT rather than through the bus
+  std::memcpy(m_ram.byte(0), m_osystem->console().system().m6532().ram(),
+              m_ram.size());
 }
 
 void StellaEnvironment::setRAM(size_t memory_index, byte_t value) {
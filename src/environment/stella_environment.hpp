@@ -31,24 +31,47 @@
 #include "games/RomSettings.hpp"
 #include "common/Log.hpp"
 #include "common/ScreenExporter.hpp"
+#include "common/ScreenRecorder.hpp"
 
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
 
 namespace ale {
+namespace stella {
+class Paddles;
+}  // namespace stella
 
 class StellaEnvironment {
  public:
   StellaEnvironment(stella::OSystem* system, RomSettings* settings);
 
-  /** Resets the system to its start state. */
+  /** Resets the system to its start state. If start states were given, the
+   *  episode starts from one of them drawn at random instead. With noop_max
+   *  set, a random number of NOOP frames from 1 to noop_max follows. Both
+   *  are drawn from the environment RNG. With cache_resets set, the state
+   *  reached by each distinct start is kept and restored by later resets. */
   void reset();
 
+  /** Sets the states episodes may start from, e.g. taken from human play,
+   *  and empties the reset cache. They should be cloned without the RNG. */
+  void setStartStates(const std::vector<ALEState>& start_states);
+  bool hasStartStates() const { return !m_start_states.empty(); }
+
+  /** Forgets the states reached by earlier resets, so the next reset of
+   *  each start is emulated again. */
+  void clearResetCache() { m_reset_cache.clear(); }
+
   /** Returns a copy of the current environment state. Note that by default this **does**
    * include the PNRG for sticky actions. You can optionally include the PRNG by setting
    * `include_rng` to true. For planning you probably want to disable
    * sticky actions. The emulator is fully deterministic. */
   ALEState cloneState(bool include_rng = false);
+  /** Same as above, storing the copy in `out` and reusing its buffer. */
+  void cloneState(ALEState& out, bool include_rng = false);
   /** Restores a previously saved copy of the state. */
   void restoreState(const ALEState&);
 
@@ -56,9 +79,33 @@ class StellaEnvironment {
    *  and performs one simulation step in Stella. Returns the resultant reward. When
    *  frame skip is set to > 1, up the corresponding number of simulation steps are performed.
    *  Note that the post-act() frame number might not correspond to the pre-act() frame
-   *  number plus the frame skip.
+   *  number plus the frame skip. If player_b_reward isn't null, player B's reward is stored
+   *  in it.
    */
-  reward_t act(Action player_a_action, Action player_b_action);
+  reward_t act(Action player_a_action, Action player_b_action,
+               reward_t* player_b_reward = NULL);
+
+  /** Moves player A's paddle straight to the given position, from 0 (leftmost)
+   *  to 1 (rightmost), then applies fire or NOOP as act() would, sticky actions
+   *  included. Throws if the game doesn't use paddles. */
+  reward_t actContinuous(float paddle_position, bool fire);
+
+  /** Applies each of the n actions in turn for player A, as act() would, writing
+   *  each step's reward to rewards_out (which may be null). Returns the index of
+   *  the step that ended the episode, or n if it didn't end. If stop_on_terminal
+   *  is set no further steps are taken and their rewards are zero. With
+   *  suppress_observations the screen and RAM are only processed after the
+   *  last step, which gives the same final observation. Player B takes the
+   *  actions in player_b_actions, or NOOPs if it is null, and its rewards
+   *  are stored in player_b_rewards_out if that isn't null. If
+   *  paddle_positions isn't null, each step moves player A's paddle to its
+   *  position first, as actContinuous() does.
+   */
+  size_t actSequence(const Action* actions, size_t n, reward_t* rewards_out,
+                     bool stop_on_terminal, bool suppress_observations,
+                     const Action* player_b_actions = NULL,
+                     reward_t* player_b_rewards_out = NULL,
+                     const float* paddle_positions = NULL);
 
   /** This functions emulates a push on the reset button of the console */
   void softReset();
@@ -98,6 +145,15 @@ class StellaEnvironment {
 
   stella::Random& getEnvironmentRNG() { return m_random; }
 
+  /** The actions last applied, which sticky actions repeat. These aren't part
+   *  of ALEState, so restoring a state keeps the current ones. */
+  Action getLastPlayerAAction() const { return m_player_a_action; }
+  Action getLastPlayerBAction() const { return m_player_b_action; }
+  void setLastActions(Action player_a_action, Action player_b_action) {
+    m_player_a_action = player_a_action;
+    m_player_b_action = player_b_action;
+  }
+
   // Returns the current difficulty switch setting in use by the environment.
   difficulty_t getDifficulty() const { return m_state.getDifficulty(); }
 
@@ -106,12 +162,17 @@ class StellaEnvironment {
   // game mode changes only take effect when the environment is reset.
   game_mode_t getMode() const { return m_state.getCurrentMode(); }
 
+  /** Adds the bytes held by the environment itself, per buffer, to the given
+   *  report. Tables shared with other environments go under "shared". */
+  void memoryFootprint(std::map<std::string, size_t>& footprint) const;
+
   /** Returns a wrapper providing #include-free access to our methods. */
   std::unique_ptr<StellaEnvironmentWrapper> getWrapper();
 
  private:
   /** This applies an action exactly one time step. Helper function to act(). */
-  reward_t oneStepAct(Action player_a_action, Action player_b_action);
+  reward_t oneStepAct(Action player_a_action, Action player_b_action,
+                      reward_t* player_b_reward);
 
   /** Actually emulates the emulator for a given number of steps. */
   void emulate(Action player_a_action, Action player_b_action,
@@ -121,15 +182,24 @@ class StellaEnvironment {
    *   from the minimal set of actions. */
   void noopIllegalActions(Action& player_a_action, Action& player_b_action);
 
+  /** Moves player A's paddle to a position from 0 (leftmost) to 1 (rightmost) */
+  void setPaddlePosition(float paddle_position);
+
+  /** Updates the game's reward and terminal state after a frame */
+  void stepSettings();
   /** Processes the current emulator screen and saves it in m_screen */
   void processScreen();
   /** Processes the emulator RAM and saves it in m_ram */
   void processRAM();
 
+  /** Resets the system, moves to the given start state (or none if
+   *  negative) and emulates the given number of NOOP frames. */
+  void emulateReset(int start, int noops);
+
  private:
   stella::OSystem* m_osystem;
   RomSettings* m_settings;
-  PhosphorBlend m_phosphor_blend; // For performing phosphor colour averaging, if so desired
+  std::unique_ptr<PhosphorBlend> m_phosphor_blend; // Only created when colour averaging is enabled
   stella::Random m_random; // Environment random number generator, used for sticky actions
   std::string m_cartridge_md5; // Necessary for saving and loading emulator state
 
@@ -138,14 +208,37 @@ class StellaEnvironment {
   ALERAM m_ram;       // The current ALE RAM
 
   bool m_use_paddles; // Whether this game uses paddles
+  stella::Paddles* m_paddles; // The paddles actions drive, if plugged in
+  bool m_suppress_observations; // Whether emulate() skips processing the screen and RAM
+  bool m_defer_settings_step;   // Whether emulate() leaves the reward and terminal state as they are
+  uint32_t m_trace_id;          // Identifies this environment's trace events
+  size_t m_state_size;          // Serialized size of the last cloned state
 
   /** Parameters loaded from Settings. */
   int m_num_reset_steps;             // Number of RESET frames per reset
   bool m_colour_averaging;           // Whether to average frames
   int m_max_num_frames_per_episode;  // Maxmimum number of frames per episode
   size_t m_frame_skip;               // How many frames to emulate per act()
+  size_t m_frame_skip_max;           // Most frames per act() with stochastic frame skip
+  bool m_step_at_skip_boundaries;    // Whether the game is only stepped on the last frame of act()
   float m_repeat_action_probability; // Stochasticity of the environment
+  uint64_t m_sticky_threshold;       // Random numbers below this repeat the last action
+  std::vector<uint32_t> m_draws;     // The random numbers of one act()
   std::unique_ptr<ScreenExporter> m_screen_exporter; // Automatic screen recorder
+  std::unique_ptr<ScreenRecorder> m_screen_recorder; // Streams frames to a single file
+  int m_noop_max;                    // Most NOOP frames at the start of an episode
+  bool m_cache_resets;               // Whether reset() restores cached states
+  bool m_ram_only;                   // Whether the screen is left undrawn
+
+  // States episodes may start from, and the state and screen reached by
+  // each reset so far, keyed by mode, difficulty, start and NOOP frames
+  struct ResetCacheEntry {
+    ALEState state;
+    ALEScreen screen;
+  };
+  using ResetKey = std::tuple<game_mode_t, difficulty_t, int, int>;
+  std::vector<ALEState> m_start_states;
+  std::map<ResetKey, ResetCacheEntry> m_reset_cache;
 
   // The last actions taken by our players
   Action m_player_a_action, m_player_b_action;
@@ -0,0 +1,138 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  trajectory.cpp
+ *
+ *  Reading and writing trajectory files.
+ **************************************************************************** */
+
+#include "environment/trajectory.hpp"
+
+#include <zlib.h>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "emucore/Deserializer.hxx"
+#include "emucore/Serializer.hxx"
+
+namespace ale {
+using namespace stella;  // Serializer, Deserializer
+
+static const uint32_t TRAJECTORY_VERSION = 1;
+
+static void writeUInt32(std::ofstream& out, uint32_t value) {
+  uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                      (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  out.write((const char*)bytes, sizeof(bytes));
+}
+
+static uint32_t readUInt32(std::ifstream& in) {
+  uint8_t bytes[4] = {0, 0, 0, 0};
+  in.read((char*)bytes, sizeof(bytes));
+  return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+const std::vector<std::string>& Trajectory::recordedSettings() {
+  static const std::vector<std::string> settings = {
+      "cpu",
+      "rng",
+      "frame_skip",
+      "frame_skip_max",
+      "repeat_action_probability",
+      "noop_max",
+      "cache_resets",
+      "max_num_frames_per_episode",
+      "paddle_min",
+      "paddle_max",
+      "color_averaging",
+  };
+  return settings;
+}
+
+size_t Trajectory::numActions() const {
+  return steps.size() - std::count(steps.begin(), steps.end(), RESET_STEP);
+}
+
+void Trajectory::save(const fs::path& path) const {
+  Serializer ser;
+  ser.putString(rom_md5);
+  ser.putInt(settings.size());
+  for (const auto& setting : settings) {
+    ser.putString(setting.first);
+    ser.putString(setting.second);
+  }
+  ser.putString(ALEState(initial_state).serialize());
+  ser.putInt(last_player_a_action);
+  ser.putInt(last_player_b_action);
+  ser.putString(std::string(steps.begin(), steps.end()));
+  const std::string payload = ser.get_str();
+
+  uLongf compressed_size = compressBound(payload.size());
+  std::vector<uint8_t> compressed(compressed_size);
+  if (compress2(compressed.data(), &compressed_size,
+                (const Bytef*)payload.data(), payload.size(),
+                Z_BEST_COMPRESSION) != Z_OK) {
+    throw std::runtime_error("Couldn't compress trajectory");
+  }
+
+  std::ofstream out(path, std::ios_base::binary);
+  out.write("ALET", 4);
+  writeUInt32(out, TRAJECTORY_VERSION);
+  writeUInt32(out, payload.size());
+  out.write((const char*)compressed.data(), compressed_size);
+  if (!out.good()) {
+    throw std::runtime_error("Couldn't write trajectory to " + path.string());
+  }
+}
+
+Trajectory Trajectory::load(const fs::path& path) {
+  std::ifstream in(path, std::ios_base::binary);
+  char magic[4] = {0, 0, 0, 0};
+  in.read(magic, sizeof(magic));
+  if (!in.good() || std::string(magic, 4) != "ALET") {
+    throw std::runtime_error(path.string() + " isn't a trajectory file");
+  }
+  if (readUInt32(in) != TRAJECTORY_VERSION) {
+    throw std::runtime_error(path.string() +
+                             " was written by an unsupported version");
+  }
+  uLongf payload_size = readUInt32(in);
+  std::string compressed((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+
+  std::string payload(payload_size, '\0');
+  if (uncompress((Bytef*)&payload[0], &payload_size,
+                 (const Bytef*)compressed.data(), compressed.size()) != Z_OK ||
+      payload_size != payload.size()) {
+    throw std::runtime_error(path.string() + " is corrupt");
+  }
+
+  Trajectory trajectory;
+  try {
+    Deserializer des(payload);
+    trajectory.rom_md5 = des.getString();
+    int num_settings = des.getInt();
+    for (int i = 0; i < num_settings; i++) {
+      std::string key = des.getString();
+      trajectory.settings.emplace_back(key, des.getString());
+    }
+    trajectory.initial_state = ALEState(des.getString());
+    trajectory.last_player_a_action = (Action)des.getInt();
+    trajectory.last_player_b_action = (Action)des.getInt();
+    std::string steps = des.getString();
+    trajectory.steps.assign(steps.begin(), steps.end());
+  } catch (const char* msg) {
+    throw std::runtime_error(path.string() + " is corrupt: " + msg);
+  }
+  return trajectory;
+}
+
+}  // namespace ale
@@ -0,0 +1,67 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  trajectory.hpp
+ *
+ *  A compact log of an episode from which it can be replayed exactly: the
+ *  ROM, the settings that affect emulation, the starting state (including
+ *  the RNG that draws sticky actions) and the actions taken. Observations
+ *  aren't stored; replaying regenerates them.
+ *
+ *  File layout, all integers little-endian:
+ *    "ALET", uint32 version (1), uint32 payload size, then the zlib
+ *    compressed payload written with stella::Serializer.
+ **************************************************************************** */
+
+#ifndef __TRAJECTORY_HPP__
+#define __TRAJECTORY_HPP__
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/Constants.h"
+#include "environment/ale_state.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ale {
+
+struct Trajectory {
+  /** Step value standing for a call to reset_game(). */
+  static constexpr uint8_t RESET_STEP = 0xFF;
+
+  /** The settings recorded alongside a trajectory, and restored before it
+   *  is replayed. */
+  static const std::vector<std::string>& recordedSettings();
+
+  std::string rom_md5;
+  std::vector<std::pair<std::string, std::string>> settings;
+  ALEState initial_state;  // Cloned with the RNG
+  Action last_player_a_action = PLAYER_A_NOOP;  // Repeated by sticky actions
+  Action last_player_b_action = PLAYER_B_NOOP;
+  std::vector<uint8_t> steps;  // Player A actions, or RESET_STEP
+
+  /** Number of act() calls in the trajectory. */
+  size_t numActions() const;
+
+  /** Writes the trajectory to a file; throws std::runtime_error on failure. */
+  void save(const fs::path& path) const;
+
+  /** Reads a trajectory written by save(); throws std::runtime_error if the
+   *  file can't be read. */
+  static Trajectory load(const fs::path& path);
+};
+
+}  // namespace ale
+
+#endif  // __TRAJECTORY_HPP__
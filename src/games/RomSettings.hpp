@@ -71,6 +71,11 @@ class RomSettings {
   // get the most recently observed reward
   virtual reward_t getReward() const = 0;
 
+  // get the most recently observed reward of player B, for games that two
+  // players can play against each other (default: none). In the modes that
+  // setMode() supports player B is the CPU opponent.
+  virtual reward_t getRewardPlayerB() const { return 0; }
+
   // the rom-name
   virtual const char* rom() const = 0;
 
@@ -86,6 +91,12 @@ class RomSettings {
   // process the latest information from ALE
   virtual void step(const stella::System& system) = 0;
 
+  // whether step() may be called only on the last frame of each act() rather
+  // than after every frame. Only safe when the reward is a difference of
+  // scores, so the rewards of the frames in between add up, and the game
+  // stays terminal once it is over (default: no)
+  virtual bool stepsAtSkipBoundaries() const { return false; }
+
   // saves the state of the rom settings
   virtual void saveState(stella::Serializer& ser) = 0;
 
@@ -10,10 +10,15 @@
  * *****************************************************************************
  */
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <memory>
+#include <vector>
 
 #include "games/Roms.hpp"
 #include "games/RomUtils.hpp"
+#include "emucore/MD5.hxx"
 
 // include the game implementations
 #include "games/supported/Adventure.hpp"
@@ -125,125 +130,207 @@ namespace fs = std::filesystem;
 
 namespace ale {
 
-/* list of supported games */
-static const RomSettings* roms[] = {
-    new AdventureSettings(),
-    new AirRaidSettings(),
-    new AlienSettings(),
-    new AmidarSettings(),
-    new AssaultSettings(),
-    new AsterixSettings(),
-    new AsteroidsSettings(),
-    new AtlantisSettings(),
-    new Atlantis2Settings(),
-    new BackgammonSettings(),
-    new BankHeistSettings(),
-    new BasicMathSettings(),
-    new BattleZoneSettings(),
-    new BeamRiderSettings(),
-    new BerzerkSettings(),
-    new BlackjackSettings(),
-    new BowlingSettings(),
-    new BoxingSettings(),
-    new BreakoutSettings(),
-    new CarnivalSettings(),
-    new CasinoSettings(),
-    new CentipedeSettings(),
-    new ChopperCommandSettings(),
-    new CrazyClimberSettings(),
-    new CrossbowSettings(),
-    new DarkChambersSettings(),
-    new DefenderSettings(),
-    new DemonAttackSettings(),
-    new DonkeyKongSettings(),
-    new DoubleDunkSettings(),
-    new EarthworldSettings(),
-    new ElevatorActionSettings(),
-    new EnduroSettings(),
-    new EntombedSettings(),
-    new EtSettings(),
-    new FishingDerbySettings(),
-    new FlagCaptureSettings(),
-    new FreewaySettings(),
-    new FroggerSettings(),
-    new FrostbiteSettings(),
-    new GalaxianSettings(),
-    new GopherSettings(),
-    new GravitarSettings(),
-    new HangmanSettings(),
-    new HauntedHouseSettings(),
-    new HeroSettings(),
-    new HumanCannonballSettings(),
-    new IceHockeySettings(),
-    new JamesBondSettings(),
-    new JourneyEscapeSettings(),
-    new KaboomSettings(),
-    new KangarooSettings(),
-    new KoolaidSettings(),
-    new KeystoneKapersSettings(),
-    new KingkongSettings(),
-    new KlaxSettings(),
-    new KrullSettings(),
-    new KungFuMasterSettings(),
-    new LaserGatesSettings(),
-    new LostLuggageSettings(),
-    new MarioBrosSettings(),
-    new MiniatureGolfSettings(),
-    new MontezumaRevengeSettings(),
-    new MrDoSettings(),
-    new MsPacmanSettings(),
-    new NameThisGameSettings(),
-    new OthelloSettings(),
-    new PacmanSettings(),
-    new PhoenixSettings(),
-    new PitfallSettings(),
-    new Pitfall2Settings(),
-    new PongSettings(),
-    new PooyanSettings(),
-    new PrivateEyeSettings(),
-    new QBertSettings(),
-    new RiverRaidSettings(),
-    new RoadRunnerSettings(),
-    new RoboTankSettings(),
-    new SeaquestSettings(),
-    new SirLancelotSettings(),
-    new SkiingSettings(),
-    new SolarisSettings(),
-    new SpaceInvadersSettings(),
-    new SpaceWarSettings(),
-    new StarGunnerSettings(),
-    new SupermanSettings(),
-    new SurroundSettings(),
-    new TennisSettings(),
-    new TetrisSettings(),
-    new TicTacToe3dSettings(),
-    new TimePilotSettings(),
-    new TurmoilSettings(),
-    new TrondeadSettings(),
-    new TutankhamSettings(),
-    new UpNDownSettings(),
-    new VentureSettings(),
-    new VideoCheckersSettings(),
-    new VideoChessSettings(),
-    new VideoCubeSettings(),
-    new VideoPinballSettings(),
-    new WizardOfWorSettings(),
-    new WordZapperSettings(),
-    new YarsRevengeSettings(),
-    new ZaxxonSettings(),
+/* constructs a fresh instance of a supported game's settings */
+template <typename T>
+static RomSettings* create() { return new T(); }
+
+typedef RomSettings* (*RomFactory)();
+
+/* list of supported games; nothing is constructed until a lookup needs it */
+static const RomFactory roms[] = {
+    &create<AdventureSettings>,
+    &create<AirRaidSettings>,
+    &create<AlienSettings>,
+    &create<AmidarSettings>,
+    &create<AssaultSettings>,
+    &create<AsterixSettings>,
+    &create<AsteroidsSettings>,
+    &create<AtlantisSettings>,
+    &create<Atlantis2Settings>,
+    &create<BackgammonSettings>,
+    &create<BankHeistSettings>,
+    &create<BasicMathSettings>,
+    &create<BattleZoneSettings>,
+    &create<BeamRiderSettings>,
+    &create<BerzerkSettings>,
+    &create<BlackjackSettings>,
+    &create<BowlingSettings>,
+    &create<BoxingSettings>,
+    &create<BreakoutSettings>,
+    &create<CarnivalSettings>,
+    &create<CasinoSettings>,
+    &create<CentipedeSettings>,
+    &create<ChopperCommandSettings>,
+    &create<CrazyClimberSettings>,
+    &create<CrossbowSettings>,
+    &create<DarkChambersSettings>,
+    &create<DefenderSettings>,
+    &create<DemonAttackSettings>,
+    &create<DonkeyKongSettings>,
+    &create<DoubleDunkSettings>,
+    &create<EarthworldSettings>,
+    &create<ElevatorActionSettings>,
+    &create<EnduroSettings>,
+    &create<EntombedSettings>,
+    &create<EtSettings>,
+    &create<FishingDerbySettings>,
+    &create<FlagCaptureSettings>,
+    &create<FreewaySettings>,
+    &create<FroggerSettings>,
+    &create<FrostbiteSettings>,
+    &create<GalaxianSettings>,
+    &create<GopherSettings>,
+    &create<GravitarSettings>,
+    &create<HangmanSettings>,
+    &create<HauntedHouseSettings>,
+    &create<HeroSettings>,
+    &create<HumanCannonballSettings>,
+    &create<IceHockeySettings>,
+    &create<JamesBondSettings>,
+    &create<JourneyEscapeSettings>,
+    &create<KaboomSettings>,
+    &create<KangarooSettings>,
+    &create<KoolaidSettings>,
+    &create<KeystoneKapersSettings>,
+    &create<KingkongSettings>,
+    &create<KlaxSettings>,
+    &create<KrullSettings>,
+    &create<KungFuMasterSettings>,
+    &create<LaserGatesSettings>,
+    &create<LostLuggageSettings>,
+    &create<MarioBrosSettings>,
+    &create<MiniatureGolfSettings>,
+    &create<MontezumaRevengeSettings>,
+    &create<MrDoSettings>,
+    &create<MsPacmanSettings>,
+    &create<NameThisGameSettings>,
+    &create<OthelloSettings>,
+    &create<PacmanSettings>,
+    &create<PhoenixSettings>,
+    &create<PitfallSettings>,
+    &create<Pitfall2Settings>,
+    &create<PongSettings>,
+    &create<PooyanSettings>,
+    &create<PrivateEyeSettings>,
+    &create<QBertSettings>,
+    &create<RiverRaidSettings>,
+    &create<RoadRunnerSettings>,
+    &create<RoboTankSettings>,
+    &create<SeaquestSettings>,
+    &create<SirLancelotSettings>,
+    &create<SkiingSettings>,
+    &create<SolarisSettings>,
+    &create<SpaceInvadersSettings>,
+    &create<SpaceWarSettings>,
+    &create<StarGunnerSettings>,
+    &create<SupermanSettings>,
+    &create<SurroundSettings>,
+    &create<TennisSettings>,
+    &create<TetrisSettings>,
+    &create<TicTacToe3dSettings>,
+    &create<TimePilotSettings>,
+    &create<TurmoilSettings>,
+    &create<TrondeadSettings>,
+    &create<TutankhamSettings>,
+    &create<UpNDownSettings>,
+    &create<VentureSettings>,
+    &create<VideoCheckersSettings>,
+    &create<VideoChessSettings>,
+    &create<VideoCubeSettings>,
+    &create<VideoPinballSettings>,
+    &create<WizardOfWorSettings>,
+    &create<WordZapperSettings>,
+    &create<YarsRevengeSettings>,
+    &create<ZaxxonSettings>,
 };
+
+static const size_t num_roms = sizeof(roms) / sizeof(roms[0]);
+
+namespace {
+
+/* index over the supported games, sorted by md5 and by rom name */
+struct RomIndex {
+  struct ByMD5 {
+    stella::MD5Key key;
+    size_t rom;
+    bool operator<(const ByMD5& other) const { return key < other.key; }
+  };
+  struct ByName {
+    const char* name;
+    size_t rom;
+    bool operator<(const ByName& other) const {
+      return std::strcmp(name, other.name) < 0;
+    }
+  };
+
+  std::vector<ByMD5> by_md5;
+  std::vector<ByName> by_name;
+  std::vector<const char*> names;
+};
+
+/* builds the index on first use by instantiating each game once; rom() and
+ * md5() return string literals so the pointers outlive the instances */
+const RomIndex& romIndex() {
+  static const RomIndex index = [] {
+    RomIndex index;
+    index.names.reserve(num_roms);
+    for (size_t i = 0; i < num_roms; i++) {
+      std::unique_ptr<RomSettings> settings(roms[i]());
+      stella::MD5Key key;
+      if (stella::parseMD5Key(settings->md5(), std::strlen(settings->md5()),
+                              key)) {
+        index.by_md5.push_back({key, i});
+      }
+      index.by_name.push_back({settings->rom(), i});
+      index.names.push_back(settings->rom());
+    }
+    std::stable_sort(index.by_md5.begin(), index.by_md5.end());
+    std::stable_sort(index.by_name.begin(), index.by_name.end());
+    return index;
+  }();
+  return index;
+}
+
+}  // namespace
+
+/* returns the index into roms[] of the game with this md5, or -1 */
+static int findRomByMD5(const std::string& rom_md5) {
+  stella::MD5Key key;
+  if (!stella::parseMD5Key(rom_md5, key)) return -1;
+
+  const RomIndex& index = romIndex();
+  RomIndex::ByMD5 probe = {key, 0};
+  auto it = std::lower_bound(index.by_md5.begin(), index.by_md5.end(), probe);
+  if (it == index.by_md5.end() || it->key != key) return -1;
+  return static_cast<int>(it->rom);
+}
+
+/* returns the index into roms[] of the game with this rom-name, or -1 */
+static int findRomByName(const std::string& rom_name) {
+  const RomIndex& index = romIndex();
+  RomIndex::ByName probe = {rom_name.c_str(), 0};
+  auto it = std::lower_bound(index.by_name.begin(), index.by_name.end(), probe);
+  if (it == index.by_name.end() || rom_name != it->name) return -1;
+  return static_cast<int>(it->rom);
+}
+
 /* looks for the RL wrapper corresponding to a particular rom filename,
  * and optionally md5. returns null if neither match */
-RomSettings* buildRomRLWrapper(const fs::path& rom, const std::string rom_md5 = std::string()){
-  // Stem is filename excluding the extension.
-  std::string rom_str = rom.stem().string();
-  std::transform(rom_str.begin(), rom_str.end(), rom_str.begin(), ::tolower);
-
-  for (size_t i = 0; i < sizeof(roms) / sizeof(roms[0]); i++) {
-    if (rom_md5 == roms[i]->md5() || rom_str == roms[i]->rom())
-      return roms[i]->clone();
+RomSettings* buildRomRLWrapper(const fs::path& rom, const std::string rom_md5){
+  int i = findRomByMD5(rom_md5);
+  if (i < 0) {
+    // Stem is filename excluding the extension.
+    std::string rom_str = rom.stem().string();
+    std::transform(rom_str.begin(), rom_str.end(), rom_str.begin(), ::tolower);
+    i = findRomByName(rom_str);
   }
-  return NULL;
+  return i < 0 ? NULL : roms[i]();
+}
+
+/* returns the rom-name of the supported game with this md5, or null */
+const char* supportedRomName(const std::string& rom_md5) {
+  int i = findRomByMD5(rom_md5);
+  return i < 0 ? NULL : romIndex().names[i];
 }
 
 }  // namespace ale
@@ -23,7 +23,11 @@ namespace fs = std::filesystem;
 namespace ale {
 
 // looks for the RL wrapper corresponding to a particular rom title
-RomSettings* buildRomRLWrapper(const fs::path& rom, const std::string md5);
+RomSettings* buildRomRLWrapper(const fs::path& rom,
+                               const std::string md5 = std::string());
+
+// returns the rom-name of the supported game with this md5, or null
+const char* supportedRomName(const std::string& md5);
 
 }  // namespace ale
 
@@ -46,6 +46,9 @@ class BoxingSettings : public RomSettings {
   // get the most recently observed reward
   reward_t getReward() const override;
 
+  // player B is the opponent, so gets the opposite reward
+  reward_t getRewardPlayerB() const override { return -m_reward; }
+
   // the rom-name
   const char* rom() const override { return "boxing"; }
 
@@ -61,6 +64,10 @@ class BoxingSettings : public RomSettings {
   // process the latest information from ALE
   void step(const stella::System& system) override;
 
+  // the reward is the change in score difference, and the game stops at a
+  // knockout or when the clock runs out
+  bool stepsAtSkipBoundaries() const override { return true; }
+
   // saves the state of the rom settings
   void saveState(stella::Serializer& ser) override;
 
@@ -46,6 +46,9 @@ class PongSettings : public RomSettings {
   // get the most recently observed reward
   reward_t getReward() const override;
 
+  // player B is the opponent, so gets the opposite reward
+  reward_t getRewardPlayerB() const override { return -m_reward; }
+
   // the rom-name
   const char* rom() const override { return "pong"; }
 
@@ -64,6 +67,9 @@ class PongSettings : public RomSettings {
   // process the latest information from ALE
   void step(const stella::System& system) override;
 
+  // the reward is the change in score difference, and play stops at 21
+  bool stepsAtSkipBoundaries() const override { return true; }
+
   // saves the state of the rom settings
   void saveState(stella::Serializer& ser) override;
 
@@ -48,6 +48,9 @@ class SurroundSettings : public RomSettings {
   // get the most recently observed reward
   reward_t getReward() const override;
 
+  // player B is the opponent, so gets the opposite reward
+  reward_t getRewardPlayerB() const override { return -m_reward; }
+
   // the rom-name
   const char* rom() const override { return "surround"; }
 
@@ -59,6 +59,9 @@ class TetrisSettings : public RomSettings {
   // process the latest information from ALE
   void step(const stella::System& system) override;
 
+  // the score only grows, and the game over flag stays set
+  bool stepsAtSkipBoundaries() const override { return true; }
+
   // saves the state of the rom settings
   void saveState(stella::Serializer& ser) override;
 
@@ -113,6 +113,12 @@ class AtariEnv(gym.Env, utils.EzPickle):
         self.ale.setLoggerMode(LoggerMode.Error)
         # Config sticky action prob.
         self.ale.setFloat("repeat_action_probability", repeat_action_probability)
+        # Frame skip, which the ALE draws from [low, high) if stochastic
+        if isinstance(frameskip, int):
+            self.ale.setInt("frame_skip", frameskip)
+        else:
+            self.ale.setInt("frame_skip", frameskip[0])
+            self.ale.setInt("frame_skip_max", frameskip[1] - 1)
 
         # If render mode is human we can display screen and sound
         if render_mode == "human":
@@ -150,8 +156,8 @@ class AtariEnv(gym.Env, utils.EzPickle):
 
     def seed(self, seed: Optional[int] = None) -> Tuple[int, int]:
         """
-        Seeds both the internal numpy rng for stochastic frame skip
-        as well as the ALE RNG.
+        Seeds both the internal numpy rng and the ALE RNG, which draws
+        sticky actions and stochastic frame skip.
 
         This function must also initialize the ROM and set the corresponding
         mode and difficulty. `seed` may be called to initialize the environment
@@ -207,19 +213,9 @@ class AtariEnv(gym.Env, utils.EzPickle):
         action = self._action_set[action_ind]
         terminal = self.ale.game_over()
 
-        # If frameskip is a length 2 tuple then it's stochastic
-        # frameskip between [frameskip[0], frameskip[1]] uniformly.
-        if isinstance(self._frameskip, int):
-            frameskip = self._frameskip
-        elif isinstance(self._frameskip, tuple):
-            frameskip = self.np_random.randint(*self._frameskip)
-        else:
-            raise error.Error(f"Invalid frameskip type: {self._frameskip}")
-
-        # Frameskip
-        reward = 0.0
-        for _ in range(frameskip):
-            reward += self.ale.act(action)
+        # The ALE repeats the action for the frame skip, drawing it
+        # uniformly from [frameskip[0], frameskip[1]) if it's stochastic
+        reward = float(self.ale.act(action))
 
         return self._get_obs(), reward, terminal, self._get_info()
 
@@ -160,6 +160,146 @@ ALEPythonInterface::getScreenGrayscale() {
   return buffer;
 }
 
+py::tuple ALEPythonInterface::actSequence(
+    const py::array_t<int, py::array::c_style | py::array::forcecast>& actions,
+    bool stop_on_terminal, bool suppress_observations,
+    const std::optional<py::array_t<int, py::array::c_style |
+                                             py::array::forcecast>>& actions_b) {
+  if (actions.ndim() != 1) {
+    throw std::runtime_error("Expected a numpy array with one dimension.");
+  }
+
+  size_t n = actions.shape(0);
+  std::vector<Action> sequence(n);
+  for (size_t i = 0; i < n; i++) {
+    sequence[i] = (Action)actions.data()[i];
+  }
+
+  if (!actions_b) {
+    py::array_t<reward_t, py::array::c_style> rewards(n);
+    size_t terminal_index =
+        ALEInterface::actSequence(sequence.data(), n, rewards.mutable_data(),
+                                  stop_on_terminal, suppress_observations);
+    return py::make_tuple(rewards, terminal_index);
+  }
+
+  if (actions_b->ndim() != 1 || (size_t)actions_b->shape(0) != n) {
+    throw std::runtime_error("Expected as many player B actions as actions.");
+  }
+  std::vector<Action> sequence_b(n);
+  for (size_t i = 0; i < n; i++) {
+    sequence_b[i] = (Action)actions_b->data()[i];
+  }
+  std::vector<reward_t> rewards_a(n), rewards_b(n);
+  size_t terminal_index = ALEInterface::actSequence(
+      sequence.data(), sequence_b.data(), n, rewards_a.data(), rewards_b.data(),
+      stop_on_terminal, suppress_observations);
+
+  py::array_t<reward_t, py::array::c_style> rewards({(py::ssize_t)n, (py::ssize_t)2});
+  for (size_t i = 0; i < n; i++) {
+    rewards.mutable_at(i, 0) = rewards_a[i];
+    rewards.mutable_at(i, 1) = rewards_b[i];
+  }
+  return py::make_tuple(rewards, terminal_index);
+}
+
+py::tuple ALEPythonInterface::actContinuousSequence(
+    const py::array_t<float, py::array::c_style | py::array::forcecast>&
+        paddle_positions,
+    const std::optional<py::array_t<bool, py::array::c_style |
+                                              py::array::forcecast>>& fire,
+    bool stop_on_terminal, bool suppress_observations) {
+  if (paddle_positions.ndim() != 1) {
+    throw std::runtime_error("Expected a numpy array with one dimension.");
+  }
+  size_t n = paddle_positions.shape(0);
+  if (fire && (fire->ndim() != 1 || (size_t)fire->shape(0) != n)) {
+    throw std::runtime_error("Expected as many fire buttons as positions.");
+  }
+
+  py::array_t<reward_t, py::array::c_style> rewards(n);
+  size_t terminal_index = ALEInterface::actContinuousSequence(
+      paddle_positions.data(), fire ? fire->data() : nullptr, n,
+      rewards.mutable_data(), stop_on_terminal, suppress_observations);
+  return py::make_tuple(rewards, terminal_index);
+}
+
+py::list ALEPythonInterface::replayTrajectories(
+    const std::vector<Trajectory>& trajectories, const fs::path& rom_file,
+    const std::string& observation, size_t threads) {
+  if (observation != "rgb" && observation != "grayscale" &&
+      observation != "screen" && observation != "ram") {
+    throw std::runtime_error("Unknown observation type " + observation);
+  }
+
+  struct Replay {
+    std::vector<pixel_t> observations;
+    std::vector<py::ssize_t> shape;  // Of one observation
+    std::vector<reward_t> rewards;
+  };
+  std::vector<Replay> replays(trajectories.size());
+  for (size_t i = 0; i < trajectories.size(); i++) {
+    replays[i].rewards.resize(trajectories[i].numActions());
+  }
+
+  {
+    // The replaying threads never touch Python objects
+    py::gil_scoped_release release;
+    ALEInterface::replayTrajectories(
+        trajectories, rom_file,
+        [&](size_t index, size_t step, reward_t reward, ALEInterface& ale) {
+          Replay& replay = replays[index];
+          replay.rewards[step] = reward;
+
+          if (observation == "ram") {
+            const ALERAM& ram = ale.getRAM();
+            replay.shape = {(py::ssize_t)ram.size()};
+            replay.observations.insert(replay.observations.end(), ram.array(),
+                                       ram.array() + ram.size());
+            return;
+          }
+
+          const ALEScreen& screen = ale.getScreen();
+          size_t h = screen.height(), w = screen.width();
+          replay.shape = {(py::ssize_t)h, (py::ssize_t)w};
+          if (observation == "rgb") {
+            replay.shape.push_back(3);
+          }
+
+          size_t offset = replay.observations.size();
+          replay.observations.resize(offset + h * w * (observation == "rgb" ? 3 : 1));
+          pixel_t* dst = replay.observations.data() + offset;
+          if (observation == "rgb") {
+            ale.theOSystem->colourPalette().applyPaletteRGB(dst, screen.getArray(), h * w);
+          } else if (observation == "grayscale") {
+            ale.theOSystem->colourPalette().applyPaletteGrayscale(dst, screen.getArray(), h * w);
+          } else {
+            std::copy(screen.getArray(), screen.getArray() + h * w, dst);
+          }
+        },
+        threads);
+  }
+
+  py::list result;
+  for (Replay& replay : replays) {
+    std::vector<py::ssize_t> shape = {(py::ssize_t)replay.rewards.size()};
+    shape.insert(shape.end(), replay.shape.begin(), replay.shape.end());
+    py::array_t<pixel_t, py::array::c_style> observations(shape);
+    std::copy(replay.observations.begin(), replay.observations.end(),
+              observations.mutable_data());
+
+    py::array_t<reward_t, py::array::c_style> rewards(replay.rewards.size(),
+                                                      replay.rewards.data());
+    result.append(py::make_tuple(observations, rewards));
+  }
+  return result;
+}
+
+py::array_t<uint8_t, py::array::c_style> ALEPythonInterface::getAudioFrame() {
+  const std::vector<uint8_t>& samples = theOSystem->sound().frameSamples();
+  return py::array_t<uint8_t, py::array::c_style>(samples.size(), samples.data());
+}
+
 const py::array_t<uint8_t, py::array::c_style> ALEPythonInterface::getRAM() {
   const ALERAM& ram = ALEInterface::getRAM();
 
@@ -189,4 +329,76 @@ void ALEPythonInterface::getRAM(
   std::copy(ram.array(), ram.array() + ram.size(), dst);
 }
 
+static py::tuple rolloutResults(RolloutEngine::Results& results,
+                                bool return_states) {
+  size_t n = results.returns.size();
+  py::array_t<reward_t, py::array::c_style> returns(n, results.returns.data());
+  py::array_t<bool, py::array::c_style> terminals(n);
+  py::array_t<size_t, py::array::c_style> lengths(n, results.lengths.data());
+  std::copy(results.terminals.begin(), results.terminals.end(),
+            terminals.mutable_data());
+
+  py::object final_states = py::none();
+  if (return_states) {
+    final_states = py::cast(std::move(results.final_states));
+  }
+  return py::make_tuple(returns, terminals, lengths, final_states);
+}
+
+py::tuple ALEPythonRolloutEngine::run(const ALEState& root, size_t rollouts,
+                                      size_t depth, const ActionVect& actions,
+                                      const std::vector<double>& probabilities,
+                                      bool return_states, uint64_t seed) {
+  RolloutEngine::Results results;
+  {
+    py::gil_scoped_release release;
+    results = RolloutEngine::run(root, rollouts, depth, actions, probabilities,
+                                 return_states, seed);
+  }
+  return rolloutResults(results, return_states);
+}
+
+py::tuple ALEPythonRolloutEngine::run(const ALEState& root, size_t rollouts,
+                                      size_t depth, const py::function& policy,
+                                      bool return_states, uint64_t seed) {
+  RolloutEngine::Results results;
+  {
+    // Emulation runs in parallel; only the policy calls take the GIL
+    py::gil_scoped_release release;
+    results = RolloutEngine::run(
+        root, rollouts, depth,
+        [&](size_t rollout, size_t step, ALEInterface& ale) {
+          const ALERAM& ram = ale.getRAM();
+          py::gil_scoped_acquire acquire;
+          py::array_t<uint8_t, py::array::c_style> ram_array(ram.size(),
+                                                             ram.array());
+          return (Action)py::int_(policy(rollout, step, ram_array)).cast<int>();
+        },
+        return_states, seed);
+  }
+  return rolloutResults(results, return_states);
+}
+
+py::tuple ALEPythonRolloutEngine::expand(const std::vector<ALEState>& states,
+                                         const ActionVect& actions,
+                                         uint64_t seed) {
+  size_t n = states.size() * actions.size();
+  std::vector<ALEState> children(n);
+  py::array_t<reward_t, py::array::c_style> rewards(
+      {(py::ssize_t)states.size(), (py::ssize_t)actions.size()});
+  std::vector<uint8_t> terminals(n);
+  {
+    py::gil_scoped_release release;
+    RolloutEngine::expand(states.data(), states.size(), actions.data(),
+                          actions.size(), children.data(),
+                          rewards.mutable_data(), terminals.data(), seed);
+  }
+
+  py::array_t<bool, py::array::c_style> terminal_array(
+      {(py::ssize_t)states.size(), (py::ssize_t)actions.size()});
+  std::copy(terminals.begin(), terminals.end(), terminal_array.mutable_data());
+  // Moved, so the serialized states aren't copied again
+  return py::make_tuple(py::cast(std::move(children)), rewards, terminal_array);
+}
+
 } // namespace ale
@@ -25,6 +25,7 @@
 #include <pybind11/stl/filesystem.h>
 
 #include "ale_interface.hpp"
+#include "rollout_engine.hpp"
 #include "version.hpp"
 
 namespace py = pybind11;
@@ -48,6 +49,26 @@ class ALEPythonInterface : public ALEInterface {
     return ALEInterface::act((Action)action);
   }
 
+  inline std::pair<reward_t, reward_t> act(unsigned int player_a_action,
+                                           unsigned int player_b_action) {
+    return ALEInterface::act((Action)player_a_action, (Action)player_b_action);
+  }
+
+  // With player B actions, rewards has a column per player
+  py::tuple actSequence(
+      const py::array_t<int, py::array::c_style | py::array::forcecast>& actions,
+      bool stop_on_terminal, bool suppress_observations,
+      const std::optional<py::array_t<int, py::array::c_style |
+                                               py::array::forcecast>>& actions_b);
+
+  // Fire is pressed at the steps where it is set, or never if it is None
+  py::tuple actContinuousSequence(
+      const py::array_t<float, py::array::c_style | py::array::forcecast>&
+          paddle_positions,
+      const std::optional<py::array_t<bool, py::array::c_style |
+                                                py::array::forcecast>>& fire,
+      bool stop_on_terminal, bool suppress_observations);
+
   inline py::tuple getScreenDims() {
     const ALEScreen& screen = ALEInterface::getScreen();
     return py::make_tuple(screen.height(), screen.width());
@@ -63,9 +84,41 @@ class ALEPythonInterface : public ALEInterface {
     return ALEInterface::isSupportedROM(rom_file);
   }
 
+  py::array_t<uint8_t, py::array::c_style> getAudioFrame();
+
   inline uint32_t getRAMSize() { return ALEInterface::getRAM().size(); }
   const py::array_t<uint8_t, py::array::c_style> getRAM();
   void getRAM(py::array_t<uint8_t, py::array::c_style>& buffer);
+
+  // Returns an (observations, rewards) tuple per trajectory, where
+  // observation is one of "rgb", "grayscale", "screen" or "ram"
+  static py::list replayTrajectories(const std::vector<Trajectory>& trajectories,
+                                     const fs::path& rom_file,
+                                     const std::string& observation,
+                                     size_t threads);
+};
+
+class ALEPythonRolloutEngine : public RolloutEngine {
+ public:
+  ALEPythonRolloutEngine(const ALEPythonInterface& ale, size_t threads)
+      : RolloutEngine(ale, threads) {}
+
+  // Both return a (returns, terminals, lengths, final_states) tuple, where
+  // final_states is None unless return_states is set
+  py::tuple run(const ALEState& root, size_t rollouts, size_t depth,
+                const ActionVect& actions,
+                const std::vector<double>& probabilities, bool return_states,
+                uint64_t seed);
+
+  // The policy is called with the rollout index, the step and the RAM
+  py::tuple run(const ALEState& root, size_t rollouts, size_t depth,
+                const py::function& policy, bool return_states, uint64_t seed);
+
+  // Returns (states, rewards, terminals), where states lists the children of
+  // each state in the order of the actions, and rewards and terminals have
+  // a row per state and a column per action
+  py::tuple expand(const std::vector<ALEState>& states,
+                   const ActionVect& actions, uint64_t seed);
 };
 
 } // namespace ale
@@ -77,6 +130,7 @@ PYBIND11_MODULE(_ale_py, m) {
 #else
   m.attr("SDL_SUPPORT") = py::bool_(false);
 #endif
+  m.attr("PERF_COUNTERS") = py::bool_(ale::PerfStats::enabled());
 
   py::enum_<ale::Action>(m, "Action")
       .value("NOOP", ale::PLAYER_A_NOOP)
@@ -105,6 +159,11 @@ PYBIND11_MODULE(_ale_py, m) {
       .value("Error", ale::Logger::mode::Error)
       .export_values();
 
+  py::enum_<ale::Logger::format>(m, "LoggerFormat")
+      .value("Text", ale::Logger::format::Text)
+      .value("JSONLines", ale::Logger::format::JSONLines)
+      .export_values();
+
   py::class_<ale::ALEState>(m, "ALEState")
       .def(py::init<>())
       .def(py::init<const ale::ALEState&, const std::string&>())
@@ -128,6 +187,14 @@ PYBIND11_MODULE(_ale_py, m) {
             return state;
           }));
 
+  py::class_<ale::Trajectory>(m, "Trajectory")
+      .def(py::init<>())
+      .def_readonly("rom_md5", &ale::Trajectory::rom_md5)
+      .def("numActions", &ale::Trajectory::numActions)
+      .def("__len__", &ale::Trajectory::numActions)
+      .def("save", &ale::Trajectory::save, py::arg("path"))
+      .def_static("load", &ale::Trajectory::load, py::arg("path"));
+
   py::class_<ale::ALEPythonInterface>(m, "ALEInterface")
       .def(py::init<>())
       .def("getString", &ale::ALEPythonInterface::getString)
@@ -142,12 +209,44 @@ PYBIND11_MODULE(_ale_py, m) {
       .def("loadROM", &ale::ALEInterface::loadROM)
       .def_static("isSupportedROM", &ale::ALEPythonInterface::isSupportedROM)
       .def_static("isSupportedROM", &ale::ALEInterface::isSupportedROM)
+      .def_static("scanROMs", &ale::ALEInterface::scanROMs,
+                  py::arg("rom_files"), py::arg("threads") = 0,
+                  py::call_guard<py::gil_scoped_release>())
+      .def_static("scanROMDirectory", &ale::ALEInterface::scanROMDirectory,
+                  py::arg("directory"), py::arg("threads") = 0,
+                  py::call_guard<py::gil_scoped_release>())
+      .def_static("profileROM", &ale::ALEInterface::profileROM,
+                  py::arg("rom_file"), py::arg("frames") = 2000,
+                  py::call_guard<py::gil_scoped_release>())
       .def("act", (ale::reward_t(ale::ALEPythonInterface::*)(uint32_t)) &
                       ale::ALEPythonInterface::act)
       .def("act", (ale::reward_t(ale::ALEInterface::*)(ale::Action)) &
                       ale::ALEInterface::act)
+      .def("act",
+           (std::pair<ale::reward_t, ale::reward_t>(
+               ale::ALEPythonInterface::*)(uint32_t, uint32_t)) &
+               ale::ALEPythonInterface::act,
+           py::arg("player_a_action"), py::arg("player_b_action"))
+      .def("act",
+           (std::pair<ale::reward_t, ale::reward_t>(ale::ALEInterface::*)(
+               ale::Action, ale::Action)) &
+               ale::ALEInterface::act,
+           py::arg("player_a_action"), py::arg("player_b_action"))
+      .def("actSequence", &ale::ALEPythonInterface::actSequence,
+           py::arg("actions"), py::arg("stop_on_terminal") = true,
+           py::arg("suppress_observations") = true,
+           py::arg("actions_b") = py::none())
+      .def("actContinuous", &ale::ALEPythonInterface::actContinuous,
+           py::arg("paddle_position"), py::arg("fire") = false)
+      .def("actContinuousSequence",
+           &ale::ALEPythonInterface::actContinuousSequence,
+           py::arg("paddle_positions"), py::arg("fire") = py::none(),
+           py::arg("stop_on_terminal") = true,
+           py::arg("suppress_observations") = true)
       .def("game_over", &ale::ALEPythonInterface::game_over)
       .def("reset_game", &ale::ALEPythonInterface::reset_game)
+      .def("setStartStates", &ale::ALEPythonInterface::setStartStates,
+           py::arg("states"))
       .def("getAvailableModes", &ale::ALEPythonInterface::getAvailableModes)
       .def("setMode", &ale::ALEPythonInterface::setMode)
       .def("getAvailableDifficulties",
@@ -189,12 +288,55 @@ PYBIND11_MODULE(_ale_py, m) {
                          py::array_t<uint8_t, py::array::c_style>&)) &
                          ale::ALEPythonInterface::getRAM)
       .def("setRAM", &ale::ALEPythonInterface::setRAM)
+      .def("getAudioFrame", &ale::ALEPythonInterface::getAudioFrame)
       .def("cloneState", &ale::ALEPythonInterface::cloneState, py::kw_only(), py::arg("include_rng") = py::bool_(false))
       .def("restoreState", &ale::ALEPythonInterface::restoreState)
       .def("cloneSystemState", &ale::ALEPythonInterface::cloneSystemState)
       .def("restoreSystemState", &ale::ALEPythonInterface::restoreSystemState)
       .def("saveScreenPNG", &ale::ALEPythonInterface::saveScreenPNG)
-      .def_static("setLoggerMode", &ale::Logger::setMode);
+      .def("memoryFootprint", &ale::ALEPythonInterface::memoryFootprint)
+      .def("getPerfStats", &ale::ALEPythonInterface::getPerfStats)
+      .def("resetPerfStats", &ale::ALEPythonInterface::resetPerfStats)
+      .def_static("enableTracing", &ale::ALEInterface::enableTracing,
+                  py::arg("events_per_thread") = 1 << 16)
+      .def_static("disableTracing", &ale::ALEInterface::disableTracing)
+      .def_static("dumpTrace", &ale::ALEInterface::dumpTrace,
+                  py::arg("path"), py::arg("clear") = false,
+                  py::call_guard<py::gil_scoped_release>())
+      .def("startTrajectory", &ale::ALEPythonInterface::startTrajectory)
+      .def("stopTrajectory", &ale::ALEPythonInterface::stopTrajectory)
+      .def("isLoggingTrajectory", &ale::ALEPythonInterface::isLoggingTrajectory)
+      .def_static("replayTrajectories",
+                  &ale::ALEPythonInterface::replayTrajectories,
+                  py::arg("trajectories"), py::arg("rom_file"),
+                  py::arg("observation") = "rgb", py::arg("threads") = 0)
+      .def_static("setLoggerMode", &ale::Logger::setMode)
+      .def_static("setLoggerFormat", &ale::Logger::setFormat)
+      .def_static("setLoggerFile", &ale::Logger::setFile)
+      .def_static("setLoggerRateLimit", &ale::Logger::setRateLimit);
+
+  py::class_<ale::ALEPythonRolloutEngine>(m, "RolloutEngine")
+      .def(py::init<const ale::ALEPythonInterface&, size_t>(), py::arg("ale"),
+           py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+      .def("run",
+           (py::tuple(ale::ALEPythonRolloutEngine::*)(
+               const ale::ALEState&, size_t, size_t, const ale::ActionVect&,
+               const std::vector<double>&, bool, uint64_t)) &
+               ale::ALEPythonRolloutEngine::run,
+           py::arg("root"), py::arg("rollouts"), py::arg("depth"),
+           py::arg("actions"), py::arg("probabilities") = std::vector<double>(),
+           py::arg("return_states") = false, py::arg("seed") = 0)
+      .def("run",
+           (py::tuple(ale::ALEPythonRolloutEngine::*)(
+               const ale::ALEState&, size_t, size_t, const py::function&, bool,
+               uint64_t)) &
+               ale::ALEPythonRolloutEngine::run,
+           py::arg("root"), py::arg("rollouts"), py::arg("depth"),
+           py::arg("policy"), py::arg("return_states") = false,
+           py::arg("seed") = 0)
+      .def("expand", &ale::ALEPythonRolloutEngine::expand, py::arg("states"),
+           py::arg("actions"), py::arg("seed") = 0)
+      .def("numThreads", &ale::ALEPythonRolloutEngine::numThreads);
 }
 
 #endif // __ALE_PYTHON_INTERFACE_HPP__
@@ -55,18 +55,19 @@ class SupportedPackage:
         roms: Dict[str, pathlib.Path] = {}
         unsupported: List[pathlib.Path] = []
 
-        # Iterate over all ROMs in the specified package
-        for resource in filter(
-            lambda file: file.suffix == ".bin", resources.files(self.package).iterdir()
-        ):
-            resolved = resource.resolve()
-            rom = ALEInterface.isSupportedROM(resolved)
+        # Hash all ROMs in the specified package in one call
+        resolved = [
+            resource.resolve()
+            for resource in resources.files(self.package).iterdir()
+            if resource.suffix == ".bin"
+        ]
+        for path, rom in ALEInterface.scanROMs(resolved).items():
             # If the ROM is supported we normalize the name and add it to
             # the dictionary of ROMs
             if rom is not None:
-                roms[rom_id_to_name(rom)] = resource.resolve()
+                roms[rom_id_to_name(rom)] = path
             else:
-                unsupported.append(resolved)
+                unsupported.append(path)
 
         return roms, unsupported
 
@@ -91,9 +92,8 @@ class SupportedEntryPoint:
             # We load the external load ROM function and
             # update the ROM dict with the result
             external_fn: Callable[[], List[Union[pathlib.Path, str]]] = external.load()
-            for path in external_fn():
-                path = pathlib.Path(path)
-                rom = ALEInterface.isSupportedROM(path)
+            paths = list(map(pathlib.Path, external_fn()))
+            for path, rom in ALEInterface.scanROMs(paths).items():
                 if rom is not None:
                     roms[rom_id_to_name(rom)] = path
                 else:
@@ -117,9 +117,10 @@ class SupportedDirectory:
         roms: Dict[str, pathlib.Path] = {}
         unsupported: List[pathlib.Path] = []
 
-        # Iterate over all bin files in directory
-        for path in self.directory.glob("*.bin"):
-            rom = ALEInterface.isSupportedROM(path)
+        # Hash all bin files in directory
+        if not self.directory.is_dir():
+            return roms, unsupported
+        for path, rom in ALEInterface.scanROMDirectory(self.directory).items():
             if rom is not None:
                 roms[rom_id_to_name(rom)] = path
             else:
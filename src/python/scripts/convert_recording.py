@@ -0,0 +1,121 @@
+import argparse
+import pathlib
+import struct
+import subprocess
+import zlib
+
+import numpy as np
+
+from ale_py import __version__
+
+VIDEO_SUFFIXES = {".mp4", ".mov", ".mkv", ".avi", ".webm"}
+
+
+def read_recording(path):
+    """
+    Yields the frames of a file written with `record_screen_file`
+    as RGB arrays of shape (height, width, 3).
+    """
+    with open(path, "rb") as f:
+        magic, version, width, height = struct.unpack("<4sIII", f.read(16))
+        if magic != b"ALEV" or version != 1:
+            raise ValueError(f"{path} isn't an ALE recording")
+        palette = np.frombuffer(f.read(256 * 3), dtype=np.uint8).reshape(256, 3)
+
+        frame_size = width * height
+        while True:
+            header = f.read(8)
+            if len(header) < 8:
+                break
+            num_frames, size = struct.unpack("<II", header)
+            chunk = np.frombuffer(zlib.decompress(f.read(size)), dtype=np.uint8)
+
+            # Frames are XORed with the previous frame of the chunk
+            frame = np.zeros(frame_size, dtype=np.uint8)
+            for i in range(num_frames):
+                frame = frame ^ chunk[i * frame_size : (i + 1) * frame_size]
+                yield palette[frame].reshape(height, width, 3)
+
+
+def write_png(path, rgb):
+    """
+    Writes an RGB array as a PNG, doubling its width like the ALE's
+    own screen exports.
+    """
+    rgb = np.repeat(rgb, 2, axis=1)
+    height, width, _ = rgb.shape
+    rows = np.concatenate([np.zeros((height, 1), dtype=np.uint8), rgb.reshape(height, -1)], axis=1)
+
+    def chunk(kind, data):
+        body = kind + data
+        return struct.pack(">I", len(data)) + body + struct.pack(">I", zlib.crc32(body))
+
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(rows.tobytes())))
+        f.write(chunk(b"IEND", b""))
+
+
+def convert(recording, output, fps=60, sound=None):
+    """
+    Writes the frames of a recording to `output`: numbered PNGs if it's a
+    directory, otherwise a video encoded by ffmpeg.
+    """
+    output = pathlib.Path(output)
+    frames = read_recording(recording)
+
+    if output.suffix.lower() not in VIDEO_SUFFIXES:
+        output.mkdir(parents=True, exist_ok=True)
+        count = 0
+        for count, frame in enumerate(frames, start=1):
+            write_png(output / f"{count - 1:06d}.png", frame)
+        return count
+
+    first = next(frames, None)
+    if first is None:
+        return 0
+    height, width, _ = first.shape
+
+    cmd = ["ffmpeg", "-y", "-loglevel", "error",
+           "-f", "rawvideo", "-pix_fmt", "rgb24", "-s", f"{width}x{height}",
+           "-r", str(fps), "-i", "-"]
+    if sound is not None:
+        cmd += ["-i", str(sound)]
+    # Undo the Atari's narrow pixels, and keep the dimensions even for yuv420p
+    cmd += ["-vf", "scale=iw*2:ih:flags=neighbor", "-pix_fmt", "yuv420p", str(output)]
+
+    count = 1
+    with subprocess.Popen(cmd, stdin=subprocess.PIPE) as ffmpeg:
+        ffmpeg.stdin.write(first.tobytes())
+        for frame in frames:
+            ffmpeg.stdin.write(frame.tobytes())
+            count += 1
+        ffmpeg.stdin.close()
+    if ffmpeg.returncode != 0:
+        raise RuntimeError(f"ffmpeg exited with status {ffmpeg.returncode}")
+    return count
+
+
+def main():
+    """
+    CLI for ale-convert-recording
+    """
+    parser = argparse.ArgumentParser(
+        description="Converts a recording made with record_screen_file into "
+        "PNG frames (when OUTPUT is a directory) or a video (when it ends "
+        f"in one of {', '.join(sorted(VIDEO_SUFFIXES))}; requires ffmpeg)."
+    )
+    parser.add_argument("--version", action="version", version=__version__)
+    parser.add_argument("--fps", type=int, default=60)
+    parser.add_argument("--sound", help="Sound file to mux into the video")
+    parser.add_argument("recording")
+    parser.add_argument("output")
+
+    args = parser.parse_args()
+    count = convert(args.recording, args.output, fps=args.fps, sound=args.sound)
+    print(f"Wrote {count} frames to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -30,10 +30,10 @@ def import_roms(romdir, datadir, pkg=None, dry_run=False):
     """
     # Get all files in romdir ending in '.bin'
     entries = list(filter(lambda file: file.suffix == ".bin", scantree(romdir)))
-    # Get ROM id or None from isSupportedROM
-    ids = list(map(ALEInterface.isSupportedROM, entries))
+    # Get ROM id or None for every file, hashed in parallel
+    ids = ALEInterface.scanROMs(entries)
     # Filter only the supported ROMs
-    supported = list(filter(lambda args: args[0] is not None, zip(ids, entries)))
+    supported = [(ids[path], path) for path in entries if ids[path] is not None]
     # Get the set of ROMs that are unsupported
     unsupported = set(entries) - set(map(operator.itemgetter(1), supported))
 
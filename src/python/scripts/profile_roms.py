@@ -0,0 +1,90 @@
+import argparse
+import csv
+import json
+import sys
+import warnings
+from concurrent.futures import ThreadPoolExecutor
+
+from ale_py import __version__, ALEInterface, LoggerMode
+
+COLUMNS = [
+    "rom",
+    "ns_per_frame",
+    "cpu_instructions_per_frame",
+    "tia_clocks_per_frame",
+    "bank_switches_per_frame",
+    "device_access_ratio",
+    "frames",
+]
+
+
+def supported_roms():
+    """
+    Returns the ROMs ale_py.roms finds, as a dict of ROM id to path.
+    """
+    with warnings.catch_warnings():
+        warnings.simplefilter("ignore")
+        from ale_py import roms
+
+        return {rom: getattr(roms, rom) for rom in roms.__all__}
+
+
+def profile_roms(roms, frames=2000, jobs=1):
+    """
+    Profiles each ROM with ALEInterface.profileROM. `roms` maps names to
+    paths. Returns a list of rows, slowest ROM first.
+    """
+
+    def profile(item):
+        name, path = item
+        return {"rom": name, **ALEInterface.profileROM(str(path), frames)}
+
+    # profileROM releases the GIL, but ROMs profiled at the same time
+    # compete for the CPU, so only run in parallel on idle machines
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        rows = list(pool.map(profile, sorted(roms.items())))
+    return sorted(rows, key=lambda row: row["ns_per_frame"], reverse=True)
+
+
+def main():
+    """
+    CLI for ale-profile-roms
+    """
+    parser = argparse.ArgumentParser(
+        description="Measures the emulation cost of ROMs: time per frame and, "
+        "when the ALE was built with PERF_COUNTERS, 6502 instructions, TIA "
+        "clocks and bank switches per frame and the fraction of memory "
+        "accesses dispatched to devices. Profiles every supported ROM unless "
+        "ROM files are given."
+    )
+    parser.add_argument("--version", action="version", version=__version__)
+    parser.add_argument("--frames", type=int, default=2000)
+    parser.add_argument("--jobs", type=int, default=1, help="ROMs to profile at once")
+    parser.add_argument("--format", choices=["table", "csv", "json"], default="table")
+    parser.add_argument("roms", nargs="*", help="ROM files")
+
+    args = parser.parse_args()
+    ALEInterface.setLoggerMode(LoggerMode.Error)
+
+    roms = {path: path for path in args.roms} if args.roms else supported_roms()
+    rows = profile_roms(roms, frames=args.frames, jobs=args.jobs)
+    columns = [column for column in COLUMNS if any(column in row for row in rows)]
+
+    if args.format == "json":
+        json.dump(rows, sys.stdout, indent=2)
+        print()
+    elif args.format == "csv":
+        writer = csv.DictWriter(sys.stdout, fieldnames=columns)
+        writer.writeheader()
+        writer.writerows(rows)
+    else:
+        print("".join(f"{column:>30}" for column in columns))
+        for row in rows:
+            print("".join(
+                f"{row[column]:>30}" if column == "rom" else f"{row[column]:>30.2f}"
+                for column in columns
+            ))
+
+
+if __name__ == "__main__":
+    main()
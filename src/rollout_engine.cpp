@@ -0,0 +1,198 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  rollout_engine.cpp
+ *
+ *  Runs many rollouts from a common root state in parallel.
+ **************************************************************************** */
+
+#include "rollout_engine.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ale {
+using namespace stella;  // Settings, SettingType
+
+namespace {
+
+// Settings that would make every environment write to the same files, or
+// open windows
+bool isCopiedSetting(SettingType id) {
+  return id != Setting_RomFile && id != Setting_RecordScreenDir &&
+         id != Setting_RecordScreenFile && id != Setting_RecordSoundFilename &&
+         id != Setting_DisplayScreen;
+}
+
+// splitmix64, which gives well mixed streams even for consecutive seeds
+class RolloutRNG {
+ public:
+  RolloutRNG(uint64_t seed, size_t rollout)
+      : m_state(seed ^ (0x9E3779B97F4A7C15ULL * (rollout + 1))) {}
+
+  uint64_t next() {
+    uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // Uniform in [0, 1)
+  double uniform() { return (next() >> 11) * (1.0 / (1ULL << 53)); }
+
+ private:
+  uint64_t m_state;
+};
+
+// Puts the environment at the root, with sticky actions drawn from the
+// rollout's generator. Returns whether the root already ended the episode.
+bool startRollout(ALEInterface& ale, const ALEState& root, RolloutRNG& rng) {
+  ale.restoreState(root);
+  ale.environment->getEnvironmentRNG().seed((uint32_t)rng.next());
+  ale.environment->setLastActions(PLAYER_A_NOOP, PLAYER_B_NOOP);
+  return ale.game_over();
+}
+
+RolloutEngine::Results makeResults(size_t rollouts, bool return_states) {
+  RolloutEngine::Results results;
+  results.returns.resize(rollouts);
+  results.terminals.resize(rollouts);
+  results.lengths.resize(rollouts);
+  if (return_states) {
+    results.final_states.resize(rollouts);
+  }
+  return results;
+}
+
+}  // namespace
+
+RolloutEngine::RolloutEngine(const ALEInterface& ale, size_t threads)
+    : m_pool(threads) {
+  if (ale.environment == nullptr) {
+    throw std::runtime_error("ROM not set");
+  }
+
+  const fs::path rom_file = ale.theOSystem->romFile();
+  for (size_t t = 0; t < m_pool.size(); t++) {
+    auto environment = std::make_unique<ALEInterface>();
+    // Set through the untyped interface, which accepts any kind of setting
+    for (int id = 0; id < LastSettingType; id++) {
+      if (isCopiedSetting((SettingType)id)) {
+        environment->theSettings->setString(
+            (SettingType)id, ale.theSettings->getString((SettingType)id));
+      }
+    }
+    environment->loadROM(rom_file);
+    m_environments.push_back(std::move(environment));
+  }
+}
+
+RolloutEngine::~RolloutEngine() {}
+
+void RolloutEngine::forEachRollout(
+    size_t n, const std::function<void(ALEInterface&, size_t)>& rollout) {
+  m_pool.parallelFor(n, [&](size_t thread, size_t i) {
+    rollout(*m_environments[thread], i);
+  });
+}
+
+RolloutEngine::Results RolloutEngine::run(
+    const ALEState& root, size_t rollouts, size_t depth,
+    const ActionVect& actions, const std::vector<double>& probabilities,
+    bool return_states, uint64_t seed) {
+  if (actions.empty()) {
+    throw std::runtime_error("No actions to roll out");
+  }
+  if (!probabilities.empty() && probabilities.size() != actions.size()) {
+    throw std::runtime_error("Expected one probability per action");
+  }
+
+  // Cumulative distribution, searched for each action
+  std::vector<double> cumulative(actions.size());
+  for (size_t a = 0; a < actions.size(); a++) {
+    double p = probabilities.empty() ? 1.0 : probabilities[a];
+    if (!(p >= 0.0)) {
+      throw std::runtime_error("Action probabilities can't be negative");
+    }
+    cumulative[a] = (a > 0 ? cumulative[a - 1] : 0.0) + p;
+  }
+  const double total = cumulative.back();
+  if (!(total > 0.0)) {
+    throw std::runtime_error("Action probabilities sum to zero");
+  }
+
+  Results results = makeResults(rollouts, return_states);
+  forEachRollout(rollouts, [&](ALEInterface& ale, size_t i) {
+    RolloutRNG rng(seed, i);
+    if (startRollout(ale, root, rng)) {
+      results.terminals[i] = true;
+    } else {
+      std::vector<Action> sequence(depth);
+      for (Action& action : sequence) {
+        double u = rng.uniform() * total;
+        size_t a = std::upper_bound(cumulative.begin(), cumulative.end(), u) -
+                   cumulative.begin();
+        action = actions[std::min(a, actions.size() - 1)];
+      }
+
+      std::vector<reward_t> rewards(depth);
+      size_t terminal_index = ale.actSequence(sequence.data(), depth,
+                                              rewards.data(), true, true);
+      for (reward_t reward : rewards) {
+        results.returns[i] += reward;
+      }
+      results.terminals[i] = terminal_index < depth;
+      results.lengths[i] = std::min(terminal_index + 1, depth);
+    }
+    if (return_states) {
+      results.final_states[i] = ale.cloneState();
+    }
+  });
+  return results;
+}
+
+RolloutEngine::Results RolloutEngine::run(const ALEState& root,
+                                          size_t rollouts, size_t depth,
+                                          const Policy& policy,
+                                          bool return_states, uint64_t seed) {
+  Results results = makeResults(rollouts, return_states);
+  forEachRollout(rollouts, [&](ALEInterface& ale, size_t i) {
+    RolloutRNG rng(seed, i);
+    bool terminal = startRollout(ale, root, rng);
+    size_t step = 0;
+    for (; step < depth && !terminal; step++) {
+      results.returns[i] += ale.act(policy(i, step, ale));
+      terminal = ale.game_over();
+    }
+    results.terminals[i] = terminal;
+    results.lengths[i] = step;
+    if (return_states) {
+      results.final_states[i] = ale.cloneState();
+    }
+  });
+  return results;
+}
+
+void RolloutEngine::expand(const ALEState* states, size_t num_states,
+                           const Action* actions, size_t num_actions,
+                           ALEState* out_states, reward_t* out_rewards,
+                           uint8_t* out_terminals, uint64_t seed) {
+  forEachRollout(num_states * num_actions, [&](ALEInterface& ale, size_t i) {
+    RolloutRNG rng(seed, i);
+    startRollout(ale, states[i / num_actions], rng);
+    // Not ale.act(), which would log the action to a trajectory
+    out_rewards[i] =
+        ale.environment->act(actions[i % num_actions], PLAYER_B_NOOP);
+    out_terminals[i] = ale.game_over();
+    ale.environment->cloneState(out_states[i]);
+  });
+}
+
+}  // namespace ale
@@ -0,0 +1,104 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  rollout_engine.hpp
+ *
+ *  Runs many rollouts from a common root state in parallel, for Monte Carlo
+ *  tree search and other planners.
+ **************************************************************************** */
+
+#ifndef __ROLLOUT_ENGINE_HPP__
+#define __ROLLOUT_ENGINE_HPP__
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ale_interface.hpp"
+#include "common/ThreadPool.hpp"
+
+namespace ale {
+
+/**
+   Keeps one environment per thread of its pool, each loaded with the ROM
+   and settings of the interface the engine was created from. A rollout
+   restores the root state into one of them and plays up to `depth` actions,
+   stopping early at the end of the episode. The threads are started with
+   the engine and reused by every call.
+
+   Rollout i draws its actions and sticky actions from a generator seeded
+   with (seed, i), so results don't depend on the number of threads or on
+   which thread ran the rollout.
+ */
+class RolloutEngine {
+ public:
+  // Creates `threads` environments (0 uses all hardware threads) from the
+  // settings and ROM of `ale`, which must have a ROM loaded. Screen and
+  // sound recording aren't copied.
+  explicit RolloutEngine(const ALEInterface& ale, size_t threads = 0);
+  ~RolloutEngine();
+
+  struct Results {
+    std::vector<reward_t> returns;       // Undiscounted sum of rewards
+    std::vector<uint8_t> terminals;      // Whether the episode ended
+    std::vector<size_t> lengths;         // Number of actions taken
+    std::vector<ALEState> final_states;  // Only filled if asked for
+  };
+
+  // Chooses the action taken at `step` of rollout `rollout`, given the
+  // environment it is running in. Called from the rollout's thread.
+  using Policy =
+      std::function<Action(size_t rollout, size_t step, ALEInterface& ale)>;
+
+  // Runs `rollouts` rollouts from root, drawing each action independently
+  // from `actions` with the given probabilities (uniformly if empty).
+  // Observations are only processed at the end of each rollout.
+  Results run(const ALEState& root, size_t rollouts, size_t depth,
+              const ActionVect& actions,
+              const std::vector<double>& probabilities = {},
+              bool return_states = false, uint64_t seed = 0);
+
+  // Runs `rollouts` rollouts from root, asking the policy for each action.
+  // The screen and RAM are kept up to date for the policy to read.
+  Results run(const ALEState& root, size_t rollouts, size_t depth,
+              const Policy& policy, bool return_states = false,
+              uint64_t seed = 0);
+
+  // Applies each of the num_actions actions to each of the num_states
+  // states, for breadth-first and beam search. The child of state s and
+  // action a, with its reward and whether it ended the episode, is stored
+  // at index s * num_actions + a of out_states, out_rewards and
+  // out_terminals. out_states is overwritten in place, so passing the same
+  // array again reuses its buffers. Sticky actions of child i are drawn
+  // from a generator seeded with (seed, i).
+  void expand(const ALEState* states, size_t num_states,
+              const Action* actions, size_t num_actions, ALEState* out_states,
+              reward_t* out_rewards, uint8_t* out_terminals,
+              uint64_t seed = 0);
+
+  // Number of environments, and so of rollouts run at once.
+  size_t numThreads() const { return m_environments.size(); }
+
+ private:
+  // Calls rollout(environment, i) for i below n on the pool, each thread
+  // using its own environment, and rethrows the first exception raised.
+  void forEachRollout(size_t n,
+                      const std::function<void(ALEInterface&, size_t)>& rollout);
+
+ private:
+  // Started once, as planners run and expand many times per search
+  ThreadPool m_pool;
+  std::vector<std::unique_ptr<ALEInterface>> m_environments;
+};
+
+}  // namespace ale
+
+#endif  // __ROLLOUT_ENGINE_HPP__
@@ -0,0 +1,447 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_bench.cpp
+ *
+ *  Throughput benchmarks for the emulator and the ALE interface. Every case
+ *  runs for a minimum amount of time and reports operations (and emulated
+ *  frames) per second. Results are printed and written to a JSON file so
+ *  they can be compared across versions.
+ *
+ *  With --baseline, the median rate of each case over --repetitions runs is
+ *  checked against a JSON file written by an earlier run, and the program
+ *  fails if any case is slower by more than --tolerance (a fraction).
+ *
+ *  Usage: ale-bench [--rom FILE]... [--out FILE] [--min-time SECONDS]
+ *                   [--filter SUBSTRING] [--repetitions N]
+ *                   [--baseline FILE] [--tolerance FRACTION]
+ **************************************************************************** */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ale_interface.hpp"
+#include "version.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::vector<fs::path> roms;
+  fs::path output = "ale-bench.json";
+  double min_time = 1.0;
+  std::string filter;
+  int repetitions = 1;
+  fs::path baseline;
+  double tolerance = 0.2;
+};
+
+struct Result {
+  std::string name;
+  std::string rom;
+  size_t iterations;
+  double seconds;
+  size_t frames;  // Emulated frames, zero for cases that don't emulate
+};
+
+// An emulator configuration that the stepping cases are run under
+struct Config {
+  const char* cpu;
+  int frame_skip;
+  bool color_averaging;
+
+  std::string str() const {
+    std::ostringstream name;
+    name << "cpu=" << cpu << "/frame_skip=" << frame_skip
+         << "/color_averaging=" << color_averaging;
+    return name.str();
+  }
+};
+
+const Config kDefaultConfig = {"low", 1, false};
+
+// Runs body until at least min_time seconds have elapsed. body performs one
+// iteration and returns the number of frames it emulated.
+Result measure(const std::string& name, const fs::path& rom, double min_time,
+               const std::function<size_t()>& body) {
+  // One untimed iteration to fault in buffers and tables
+  body();
+
+  Result result = {name, rom.filename().string(), 0, 0.0, 0};
+  Clock::time_point start = Clock::now();
+  for (size_t batch = 1;; batch = std::min<size_t>(batch * 2, 1024)) {
+    for (size_t i = 0; i < batch; i++) {
+      result.frames += body();
+    }
+    result.iterations += batch;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (result.seconds >= min_time) break;
+  }
+
+  return result;
+}
+
+void loadROM(ale::ALEInterface& ale, const fs::path& rom, const Config& config) {
+  ale.setInt("random_seed", 0);
+  ale.setString("cpu", config.cpu);
+  ale.setInt("frame_skip", config.frame_skip);
+  ale.setBool("color_averaging", config.color_averaging);
+  ale.loadROM(rom);
+}
+
+class Benchmark {
+ public:
+  explicit Benchmark(const Options& options) : m_options(options) {}
+
+  const std::vector<Result>& results() const { return m_results; }
+
+  void run(const std::string& name, const fs::path& rom,
+           const std::function<size_t()>& body) {
+    if (name.find(m_options.filter) == std::string::npos) return;
+
+    // Keep the run with the median rate
+    std::vector<Result> runs;
+    for (int i = 0; i < std::max(m_options.repetitions, 1); i++) {
+      runs.push_back(measure(name, rom, m_options.min_time, body));
+    }
+    std::sort(runs.begin(), runs.end(), [](const Result& a, const Result& b) {
+      return a.iterations / a.seconds < b.iterations / b.seconds;
+    });
+    const Result& result = runs[runs.size() / 2];
+    print(result);
+    m_results.push_back(result);
+  }
+
+  // Steps through random actions from the minimal action set, resetting at
+  // the end of each episode, under every configuration we track.
+  void step(const fs::path& rom) {
+    const std::string stem = rom.stem().string();
+    for (const char* cpu : {"low", "high"}) {
+      for (int frame_skip : {1, 4}) {
+        for (bool color_averaging : {false, true}) {
+          Config config = {cpu, frame_skip, color_averaging};
+          std::string name = stem + "/step/" + config.str();
+          if (name.find(m_options.filter) == std::string::npos) continue;
+
+          ale::ALEInterface ale;
+          loadROM(ale, rom, config);
+          ale::ActionVect actions = ale.getMinimalActionSet();
+          std::mt19937 rng(0);
+
+          run(name, rom, [&]() -> size_t {
+            int frame = ale.getFrameNumber();
+            ale.act(actions[rng() % actions.size()]);
+            if (ale.game_over()) ale.reset_game();
+            return ale.getFrameNumber() - frame;
+          });
+        }
+      }
+    }
+
+    std::string name = stem + "/act_sequence/" + kDefaultConfig.str();
+    if (name.find(m_options.filter) == std::string::npos) return;
+
+    ale::ALEInterface ale;
+    loadROM(ale, rom, kDefaultConfig);
+    ale::ActionVect minimal = ale.getMinimalActionSet();
+    std::mt19937 rng(0);
+    std::vector<ale::Action> actions(64);
+    std::vector<ale::reward_t> rewards(actions.size());
+    for (ale::Action& action : actions) {
+      action = minimal[rng() % minimal.size()];
+    }
+
+    run(name, rom, [&]() -> size_t {
+      int frame = ale.getFrameNumber();
+      ale.actSequence(actions.data(), actions.size(), rewards.data());
+      if (ale.game_over()) ale.reset_game();
+      return ale.getFrameNumber() - frame;
+    });
+  }
+
+  // Costs of the operations search and training loops perform between steps
+  void interface(const fs::path& rom) {
+    const std::string stem = rom.stem().string();
+
+    ale::ALEInterface ale;
+    loadROM(ale, rom, kDefaultConfig);
+    ale::ActionVect actions = ale.getMinimalActionSet();
+    std::mt19937 rng(0);
+    for (int i = 0; i < 500 && !ale.game_over(); i++) {
+      ale.act(actions[rng() % actions.size()]);
+    }
+
+    ale::ALEState state = ale.cloneState();
+    run(stem + "/clone_state", rom, [&]() -> size_t {
+      state = ale.cloneState();
+      return 0;
+    });
+    run(stem + "/restore_state", rom, [&]() -> size_t {
+      ale.restoreState(state);
+      return 0;
+    });
+    run(stem + "/clone_system_state", rom, [&]() -> size_t {
+      state = ale.cloneSystemState();
+      return 0;
+    });
+    run(stem + "/reset", rom, [&]() -> size_t {
+      int frame = ale.getFrameNumber();
+      ale.reset_game();
+      return ale.getFrameNumber() - frame;
+    });
+
+    std::vector<unsigned char> buffer;
+    run(stem + "/get_screen_rgb", rom, [&]() -> size_t {
+      ale.getScreenRGB(buffer);
+      return 0;
+    });
+    run(stem + "/get_screen_grayscale", rom, [&]() -> size_t {
+      ale.getScreenGrayscale(buffer);
+      return 0;
+    });
+    run(stem + "/get_ram", rom, [&]() -> size_t {
+      const ale::ALERAM& ram = ale.getRAM();
+      buffer.assign(ram.array(), ram.array() + ram.size());
+      return 0;
+    });
+  }
+
+  void scan(const std::vector<fs::path>& files) {
+    run("scan_roms", files.front(), [&]() -> size_t {
+      ale::ALEInterface::scanROMs(files, 1);
+      return 0;
+    });
+  }
+
+ private:
+  static void print(const Result& result) {
+    double rate = result.iterations / result.seconds;
+    std::printf("%-60s %10zu %14.1f/s", result.name.c_str(), result.iterations,
+                rate);
+    if (result.frames > 0) {
+      std::printf(" %14.1f frames/s", result.frames / result.seconds);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+  }
+
+  const Options& m_options;
+  std::vector<Result> m_results;
+};
+
+std::string escape(const std::string& s) {
+  std::string escaped;
+  for (char c : s) {
+    if (c == '"' || c == '\\') escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+void writeJSON(const fs::path& path, const std::vector<Result>& results) {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "Unable to write " << path << std::endl;
+    std::exit(1);
+  }
+
+  std::time_t now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+  out << "{\n"
+      << "  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"ale_version\": \"" << ALE_VERSION << "\",\n"
+      << "    \"git_sha\": \"" << ALE_VERSION_GIT_SHA << "\",\n"
+      << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+      << "    \"build_type\": \"release\"\n"
+#else
+      << "    \"build_type\": \"debug\"\n"
+#endif
+      << "  },\n"
+      << "  \"benchmarks\": [";
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& r = results[i];
+    out << (i == 0 ? "\n" : ",\n")
+        << "    {\"name\": \"" << escape(r.name) << "\", "
+        << "\"rom\": \"" << escape(r.rom) << "\", "
+        << "\"iterations\": " << r.iterations << ", "
+        << "\"seconds\": " << r.seconds << ", "
+        << "\"items_per_second\": " << r.iterations / r.seconds;
+    if (r.frames > 0) {
+      out << ", \"frames\": " << r.frames
+          << ", \"frames_per_second\": " << r.frames / r.seconds;
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+// Reads the rates of a JSON file written by writeJSON. It's not a general
+// JSON parser; it relies on each case being on a line of its own.
+std::map<std::string, double> readBaseline(const fs::path& path) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "Unable to read " << path << std::endl;
+    std::exit(1);
+  }
+
+  const std::string name_key = "\"name\": \"";
+  const std::string rate_key = "\"items_per_second\": ";
+  std::map<std::string, double> rates;
+  for (std::string line; std::getline(in, line);) {
+    size_t name = line.find(name_key);
+    size_t rate = line.find(rate_key);
+    if (name == std::string::npos || rate == std::string::npos) continue;
+
+    name += name_key.size();
+    std::string unescaped;
+    for (size_t i = name; i < line.size() && line[i] != '"'; i++) {
+      if (line[i] == '\\') i++;
+      unescaped += line[i];
+    }
+    rates[unescaped] = std::atof(line.c_str() + rate + rate_key.size());
+  }
+  return rates;
+}
+
+// Cases faster than this (under a microsecond) aren't checked. Their timings
+// swing by half with code and stack alignment, e.g. under ctest.
+const double kMaxGatedRate = 1e6;
+
+// Compares results against the baseline, returning false on a regression
+bool checkBaseline(const std::vector<Result>& results,
+                   const std::map<std::string, double>& baseline,
+                   double tolerance) {
+  bool passed = true;
+  std::set<std::string> ran;
+  std::printf("\nComparing against the baseline (tolerance %.0f%%)\n",
+              tolerance * 100);
+  for (const Result& r : results) {
+    ran.insert(r.name);
+    auto expected = baseline.find(r.name);
+    if (expected == baseline.end()) {
+      std::printf("%-60s no baseline\n", r.name.c_str());
+      continue;
+    }
+
+    double rate = r.iterations / r.seconds;
+    double change = rate / expected->second - 1;
+    const char* verdict = "ok";
+    if (expected->second > kMaxGatedRate) {
+      verdict = "too short to check";
+    } else if (change < -tolerance) {
+      verdict = "REGRESSION";
+      passed = false;
+    } else if (change > tolerance) {
+      verdict = "faster, consider updating the baseline";
+    }
+    std::printf("%-60s %+7.1f%%  %s\n", r.name.c_str(), change * 100, verdict);
+  }
+
+  for (const auto& entry : baseline) {
+    if (!ran.count(entry.first)) {
+      std::printf("%-60s not run\n", entry.first.c_str());
+    }
+  }
+
+  if (!passed) {
+    std::printf("\nFAILED: some cases are more than %.0f%% slower than the "
+                "baseline\n", tolerance * 100);
+  }
+  std::fflush(stdout);
+  return passed;
+}
+
+void usage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--rom FILE]... [--out FILE] [--min-time SECONDS]"
+            << " [--filter SUBSTRING] [--repetitions N]"
+            << " [--baseline FILE] [--tolerance FRACTION]" << std::endl;
+  std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) usage(argv[0]);
+    if (arg == "--rom") {
+      options.roms.push_back(argv[++i]);
+    } else if (arg == "--out") {
+      options.output = argv[++i];
+    } else if (arg == "--min-time") {
+      options.min_time = std::atof(argv[++i]);
+    } else if (arg == "--filter") {
+      options.filter = argv[++i];
+    } else if (arg == "--repetitions") {
+      options.repetitions = std::atoi(argv[++i]);
+    } else if (arg == "--baseline") {
+      options.baseline = argv[++i];
+    } else if (arg == "--tolerance") {
+      options.tolerance = std::atof(argv[++i]);
+    } else {
+      usage(argv[0]);
+    }
+  }
+
+  // The bundled test ROMs make the suite runnable without any other ROMs
+  const fs::path resources = ALE_BENCH_RESOURCE_DIR;
+  if (options.roms.empty()) {
+    options.roms.push_back(resources / "tetris.bin");
+  }
+
+  ale::Logger::setMode(ale::Logger::Error);
+
+  Benchmark benchmark(options);
+  for (const fs::path& rom : options.roms) {
+    benchmark.step(rom);
+    benchmark.interface(rom);
+  }
+
+  // Hashing includes a ROM no game supports, which is the common case when
+  // importing a directory of ROMs
+  std::vector<fs::path> files = options.roms;
+  files.push_back(resources / "random.bin");
+  benchmark.scan(files);
+
+  writeJSON(options.output, benchmark.results());
+  std::cout << "Wrote " << options.output.string() << std::endl;
+
+  if (!options.baseline.empty() &&
+      !checkBaseline(benchmark.results(), readBaseline(options.baseline),
+                     options.tolerance)) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,522 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  ale_golden.cpp
+ *
+ *  Golden traces for differential testing of the emulator. `record` runs
+ *  each ROM for a number of frames under scripted random actions and stores
+ *  per-frame hashes of the screen, RAM and CPU registers along with the
+ *  reward and terminal flag. `compare` replays the same actions, possibly
+ *  under another build or other settings (e.g. `--set cpu=high`), and
+ *  reports the first frame at which each ROM diverges from the reference.
+ *  ROMs run in parallel.
+ *
+ *  Usage: ale-golden record [--rom FILE]... [--roms DIR]... [--out FILE]
+ *                           [--frames N] [--seed N] [--set KEY=VALUE]...
+ *                           [--threads N]
+ *         ale-golden compare --reference FILE [--rom FILE]... [--roms DIR]...
+ *                            [--set KEY=VALUE]... [--threads N]
+ *                            [--ignore screen|ram|cpu]...
+ *
+ *  `--ignore` leaves a part of each frame out of the comparison, e.g. the
+ *  screen under `--set ram_only=1`, which doesn't draw it.
+ *
+ *  File layout, all integers little-endian:
+ *    "ALEG", uint32 version (1), uint32 payload size, then the zlib
+ *    compressed payload written with stella::Serializer: the ALE version
+ *    and git SHA that recorded it, the seed, the number of frames, the
+ *    settings and, for each ROM, its MD5, file name and packed frames.
+ **************************************************************************** */
+
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ale_interface.hpp"
+#include "emucore/Deserializer.hxx"
+#include "emucore/M6502.hxx"
+#include "emucore/Serializer.hxx"
+#include "emucore/Settings.hxx"
+#include "version.hpp"
+
+namespace fs = std::filesystem;
+namespace stella = ale::stella;
+
+namespace {
+
+const uint32_t kGoldenVersion = 1;
+
+using Settings = std::vector<std::pair<std::string, std::string>>;
+
+struct Options {
+  std::string mode;
+  std::vector<fs::path> roms;
+  std::vector<fs::path> rom_dirs;
+  fs::path output = "ale-golden.bin";
+  fs::path reference;
+  int frames = 2000;
+  int seed = 0;
+  size_t threads = 0;
+  Settings settings;
+  std::vector<std::string> ignored;  // Parts of frames left out of compare
+};
+
+// What we check after every act(). The hashes are FNV-1a.
+struct Frame {
+  uint32_t screen;
+  uint32_t ram;
+  uint32_t cpu;
+  int32_t reward;
+  uint8_t terminal;
+};
+
+const size_t kPackedFrameSize = 17;
+
+struct Trace {
+  std::string md5;
+  std::string rom;  // File name, used to find the ROM when comparing
+  std::vector<Frame> frames;
+  std::string error;  // Set if the ROM couldn't be run
+};
+
+struct Golden {
+  std::string ale_version;
+  std::string git_sha;
+  int seed;
+  int frames;
+  Settings settings;
+  std::vector<Trace> traces;
+};
+
+uint32_t fnv1a(const uint8_t* data, size_t size, uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+uint32_t fnv1a(const std::string& s) {
+  return fnv1a((const uint8_t*)s.data(), s.size());
+}
+
+// Runs a ROM for `frames` frames, stepping through actions from its minimal
+// action set drawn from a generator seeded by `seed` and the ROM's MD5.
+// Only the raw output of std::mt19937 is used, as it's the same with every
+// standard library.
+Trace run(const fs::path& rom, int frames, int seed, const Settings& settings) {
+  Trace trace;
+  trace.rom = rom.filename().string();
+  try {
+    ale::ALEInterface ale;
+    ale.setInt("random_seed", seed);
+    for (const auto& setting : settings) {
+      stella::SettingType id = stella::Settings::lookup(setting.first);
+      if (id == stella::LastSettingType) {
+        throw std::runtime_error("Unknown setting " + setting.first);
+      }
+      ale.theSettings->setString(id, setting.second);
+    }
+    ale.loadROM(rom);
+    const stella::Console& console = ale.theOSystem->console();
+    trace.md5 = console.properties().get(stella::Cartridge_MD5);
+
+    const ale::ActionVect actions = ale.getMinimalActionSet();
+    std::mt19937 rng(seed ^ fnv1a(trace.md5));
+    const stella::M6502& cpu = console.system().m6502();
+
+    trace.frames.reserve(frames);
+    for (int i = 0; i < frames; i++) {
+      Frame frame;
+      frame.reward = ale.act(actions[rng() % actions.size()]);
+      frame.terminal = ale.game_over();
+
+      const ale::ALEScreen& screen = ale.getScreen();
+      frame.screen = fnv1a(screen.getArray(), screen.arraySize());
+      const ale::ALERAM& ram = ale.getRAM();
+      frame.ram = fnv1a(ram.array(), ram.size());
+      uint8_t registers[8];
+      cpu.getRegisters(registers);
+      frame.cpu = fnv1a(registers, sizeof(registers));
+
+      trace.frames.push_back(frame);
+      if (frame.terminal) ale.reset_game();
+    }
+  } catch (const std::exception& e) {
+    trace.error = e.what();
+  }
+  return trace;
+}
+
+// Runs every ROM, spread over `threads` worker threads
+std::vector<Trace> runAll(const std::vector<fs::path>& roms, int frames,
+                          int seed, const Settings& settings, size_t threads) {
+  std::vector<Trace> traces(roms.size());
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, roms.size());
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i; (i = next++) < roms.size();) {
+      traces[i] = run(roms[i], frames, seed, settings);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (size_t i = 1; i < threads; i++) pool.emplace_back(worker);
+  worker();
+  for (std::thread& thread : pool) thread.join();
+
+  return traces;
+}
+
+void putUInt32(std::string& out, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) out += (char)(value >> shift);
+}
+
+uint32_t getUInt32(const std::string& in, size_t offset) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= (uint32_t)(uint8_t)in[offset + i] << (8 * i);
+  }
+  return value;
+}
+
+std::string packFrames(const std::vector<Frame>& frames) {
+  std::string packed;
+  packed.reserve(frames.size() * kPackedFrameSize);
+  for (const Frame& frame : frames) {
+    putUInt32(packed, frame.screen);
+    putUInt32(packed, frame.ram);
+    putUInt32(packed, frame.cpu);
+    putUInt32(packed, frame.reward);
+    packed += (char)frame.terminal;
+  }
+  return packed;
+}
+
+std::vector<Frame> unpackFrames(const std::string& packed) {
+  std::vector<Frame> frames(packed.size() / kPackedFrameSize);
+  for (size_t i = 0; i < frames.size(); i++) {
+    size_t offset = i * kPackedFrameSize;
+    frames[i].screen = getUInt32(packed, offset);
+    frames[i].ram = getUInt32(packed, offset + 4);
+    frames[i].cpu = getUInt32(packed, offset + 8);
+    frames[i].reward = (int32_t)getUInt32(packed, offset + 12);
+    frames[i].terminal = packed[offset + 16];
+  }
+  return frames;
+}
+
+void save(const fs::path& path, const Golden& golden) {
+  stella::Serializer ser;
+  ser.putString(golden.ale_version);
+  ser.putString(golden.git_sha);
+  ser.putInt(golden.seed);
+  ser.putInt(golden.frames);
+  ser.putInt(golden.settings.size());
+  for (const auto& setting : golden.settings) {
+    ser.putString(setting.first);
+    ser.putString(setting.second);
+  }
+  ser.putInt(golden.traces.size());
+  for (const Trace& trace : golden.traces) {
+    ser.putString(trace.md5);
+    ser.putString(trace.rom);
+    ser.putString(packFrames(trace.frames));
+  }
+  const std::string payload = ser.get_str();
+
+  uLongf compressed_size = compressBound(payload.size());
+  std::string compressed(compressed_size, '\0');
+  if (compress2((Bytef*)&compressed[0], &compressed_size,
+                (const Bytef*)payload.data(), payload.size(),
+                Z_BEST_COMPRESSION) != Z_OK) {
+    throw std::runtime_error("Couldn't compress the traces");
+  }
+  compressed.resize(compressed_size);
+
+  std::string header = "ALEG";
+  putUInt32(header, kGoldenVersion);
+  putUInt32(header, payload.size());
+
+  std::ofstream out(path, std::ios_base::binary);
+  out << header << compressed;
+  if (!out.good()) {
+    throw std::runtime_error("Couldn't write " + path.string());
+  }
+}
+
+Golden load(const fs::path& path) {
+  std::ifstream in(path, std::ios_base::binary);
+  std::string file((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  if (file.size() < 12 || file.compare(0, 4, "ALEG") != 0) {
+    throw std::runtime_error(path.string() + " isn't a golden trace file");
+  }
+  if (getUInt32(file, 4) != kGoldenVersion) {
+    throw std::runtime_error(path.string() +
+                             " was written by an unsupported version");
+  }
+
+  uLongf payload_size = getUInt32(file, 8);
+  std::string payload(payload_size, '\0');
+  if (uncompress((Bytef*)&payload[0], &payload_size,
+                 (const Bytef*)file.data() + 12, file.size() - 12) != Z_OK ||
+      payload_size != payload.size()) {
+    throw std::runtime_error(path.string() + " is corrupt");
+  }
+
+  Golden golden;
+  try {
+    stella::Deserializer des(payload);
+    golden.ale_version = des.getString();
+    golden.git_sha = des.getString();
+    golden.seed = des.getInt();
+    golden.frames = des.getInt();
+    int num_settings = des.getInt();
+    for (int i = 0; i < num_settings; i++) {
+      std::string key = des.getString();
+      golden.settings.emplace_back(key, des.getString());
+    }
+    golden.traces.resize(des.getInt());
+    for (Trace& trace : golden.traces) {
+      trace.md5 = des.getString();
+      trace.rom = des.getString();
+      trace.frames = unpackFrames(des.getString());
+    }
+  } catch (const char* msg) {
+    throw std::runtime_error(path.string() + " is corrupt: " + msg);
+  }
+  return golden;
+}
+
+// Names the parts of two frames that differ, other than the ignored ones
+std::string difference(const Frame& expected, const Frame& actual,
+                       const std::vector<std::string>& ignored = {}) {
+  auto compared = [&](const std::string& part) {
+    return std::find(ignored.begin(), ignored.end(), part) == ignored.end();
+  };
+  std::vector<std::string> parts;
+  if (compared("screen") && expected.screen != actual.screen) {
+    parts.push_back("screen");
+  }
+  if (compared("ram") && expected.ram != actual.ram) parts.push_back("ram");
+  if (compared("cpu") && expected.cpu != actual.cpu) parts.push_back("cpu");
+  if (expected.reward != actual.reward) {
+    parts.push_back("reward " + std::to_string(expected.reward) + " != " +
+                    std::to_string(actual.reward));
+  }
+  if (expected.terminal != actual.terminal) parts.push_back("terminal");
+
+  std::string joined;
+  for (const std::string& part : parts) {
+    joined += (joined.empty() ? "" : ", ") + part;
+  }
+  return joined;
+}
+
+// Every ROM named on the command line, and the .bin files in the directories
+std::vector<fs::path> listROMs(const Options& options) {
+  std::vector<fs::path> roms = options.roms;
+  for (const fs::path& dir : options.rom_dirs) {
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+        files.push_back(entry.path());
+      }
+    }
+    std::sort(files.begin(), files.end());
+    roms.insert(roms.end(), files.begin(), files.end());
+  }
+  return roms;
+}
+
+int record(const Options& options) {
+  std::vector<fs::path> roms = options.roms;
+  // Only keep the supported ROMs from directories, which usually hold others
+  for (const fs::path& dir : options.rom_dirs) {
+    for (const auto& entry :
+         ale::ALEInterface::scanROMDirectory(dir, options.threads)) {
+      if (entry.second) roms.push_back(entry.first);
+    }
+  }
+  if (roms.empty()) {
+    roms.push_back(fs::path(ALE_GOLDEN_RESOURCE_DIR) / "tetris.bin");
+  }
+
+  Golden golden;
+  golden.ale_version = ALE_VERSION;
+  golden.git_sha = ALE_VERSION_GIT_SHA;
+  golden.seed = options.seed;
+  golden.frames = options.frames;
+  golden.settings = options.settings;
+  golden.traces = runAll(roms, options.frames, options.seed, options.settings,
+                         options.threads);
+
+  int status = 0;
+  for (const Trace& trace : golden.traces) {
+    if (!trace.error.empty()) {
+      std::cerr << trace.rom << ": " << trace.error << std::endl;
+      status = 1;
+    }
+  }
+  if (status != 0) return status;
+
+  save(options.output, golden);
+  std::cout << "Wrote " << golden.traces.size() << " traces of "
+            << golden.frames << " frames to " << options.output.string()
+            << std::endl;
+  return 0;
+}
+
+int compare(const Options& options) {
+  const Golden golden = load(options.reference);
+
+  // Settings given here override the recorded ones
+  Settings settings = golden.settings;
+  settings.insert(settings.end(), options.settings.begin(),
+                  options.settings.end());
+
+  Options search = options;
+  if (search.roms.empty() && search.rom_dirs.empty()) {
+    search.rom_dirs.push_back(ALE_GOLDEN_RESOURCE_DIR);
+  }
+  const std::vector<fs::path> candidates = listROMs(search);
+
+  std::vector<fs::path> roms;
+  std::vector<const Trace*> expected;
+  int status = 0;
+  for (const Trace& trace : golden.traces) {
+    auto found = std::find_if(candidates.begin(), candidates.end(),
+                              [&](const fs::path& path) {
+                                return path.filename() == trace.rom;
+                              });
+    if (found == candidates.end()) {
+      std::cout << trace.rom << ": not found" << std::endl;
+      status = 1;
+      continue;
+    }
+    roms.push_back(*found);
+    expected.push_back(&trace);
+  }
+
+  const std::vector<Trace> traces =
+      runAll(roms, golden.frames, golden.seed, settings, options.threads);
+
+  for (size_t i = 0; i < traces.size(); i++) {
+    const Trace& reference = *expected[i];
+    const Trace& trace = traces[i];
+    std::cout << reference.rom << ": ";
+    if (!trace.error.empty()) {
+      std::cout << trace.error << std::endl;
+      status = 1;
+      continue;
+    }
+    if (trace.md5 != reference.md5) {
+      std::cout << "MD5 " << trace.md5 << " doesn't match the reference "
+                << reference.md5 << std::endl;
+      status = 1;
+      continue;
+    }
+
+    auto same = [&](const Frame& a, const Frame& b) {
+      return difference(a, b, options.ignored).empty();
+    };
+    auto diverged = std::mismatch(reference.frames.begin(),
+                                  reference.frames.end(), trace.frames.begin(),
+                                  same);
+    if (diverged.first == reference.frames.end()) {
+      std::cout << "identical over " << reference.frames.size() << " frames"
+                << std::endl;
+    } else {
+      std::cout << "diverged at frame "
+                << diverged.first - reference.frames.begin() << " ("
+                << difference(*diverged.first, *diverged.second,
+                              options.ignored)
+                << ")"
+                << std::endl;
+      status = 1;
+    }
+  }
+  return status;
+}
+
+void usage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " record [--rom FILE]... [--roms DIR]... [--out FILE]"
+            << " [--frames N] [--seed N] [--set KEY=VALUE]... [--threads N]\n"
+            << "       " << program
+            << " compare --reference FILE [--rom FILE]... [--roms DIR]..."
+            << " [--set KEY=VALUE]... [--threads N]"
+            << " [--ignore screen|ram|cpu]..." << std::endl;
+  std::exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) usage(argv[0]);
+
+  Options options;
+  options.mode = argv[1];
+  if (options.mode != "record" && options.mode != "compare") usage(argv[0]);
+
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) usage(argv[0]);
+    if (arg == "--rom") {
+      options.roms.push_back(argv[++i]);
+    } else if (arg == "--roms") {
+      options.rom_dirs.push_back(argv[++i]);
+    } else if (arg == "--out") {
+      options.output = argv[++i];
+    } else if (arg == "--reference") {
+      options.reference = argv[++i];
+    } else if (arg == "--frames") {
+      options.frames = std::atoi(argv[++i]);
+    } else if (arg == "--seed") {
+      options.seed = std::atoi(argv[++i]);
+    } else if (arg == "--threads") {
+      options.threads = std::atoi(argv[++i]);
+    } else if (arg == "--set") {
+      std::string setting = argv[++i];
+      size_t equals = setting.find('=');
+      if (equals == std::string::npos) usage(argv[0]);
+      options.settings.emplace_back(setting.substr(0, equals),
+                                    setting.substr(equals + 1));
+    } else if (arg == "--ignore") {
+      std::string part = argv[++i];
+      if (part != "screen" && part != "ram" && part != "cpu") usage(argv[0]);
+      options.ignored.push_back(part);
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (options.mode == "compare" && options.reference.empty()) usage(argv[0]);
+
+  ale::Logger::setMode(ale::Logger::Error);
+
+  try {
+    return options.mode == "record" ? record(options) : compare(options);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
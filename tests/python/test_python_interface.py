@@ -1,7 +1,10 @@
 import pytest
+import json
 import os
+import pathlib
 import pickle
 import tempfile
+import wave
 import numpy as np
 import ale_py
 
@@ -52,6 +55,140 @@ def test_act(tetris):
     tetris.act(0)  # integer instead of enum
 
 
+def test_act_sequence(test_rom_path):
+    actions = np.random.randint(0, 5, size=2000)
+    ales = [ale_py.ALEInterface() for _ in range(2)]
+    for ale in ales:
+        ale.setInt("random_seed", 123)
+        ale.loadROM(test_rom_path)
+
+    expected = [ales[0].act(int(a)) for a in actions]
+    rewards, terminal = ales[1].actSequence(actions, stop_on_terminal=False)
+    assert rewards.shape == (len(actions),)
+    assert list(rewards) == expected
+    assert terminal == len(actions) or ales[1].game_over()
+    assert np.array_equal(ales[0].getRAM(), ales[1].getRAM())
+    assert np.array_equal(ales[0].getScreenRGB(), ales[1].getScreenRGB())
+
+
+def test_stochastic_frame_skip(test_rom_path):
+    frames = []
+    for _ in range(2):
+        ale = ale_py.ALEInterface()
+        ale.setInt("random_seed", 7)
+        ale.setInt("frame_skip", 2)
+        ale.setInt("frame_skip_max", 4)
+        ale.loadROM(test_rom_path)
+
+        skips = []
+        for _ in range(200):
+            start = ale.getFrameNumber()
+            ale.act(0)
+            skips.append(ale.getFrameNumber() - start)
+        frames.append(skips)
+
+    assert set(frames[0]) == {2, 3, 4}
+    assert frames[0] == frames[1]
+
+
+def test_act_two_players(test_rom_path):
+    actions = np.random.randint(0, 5, size=300)
+    ales = [ale_py.ALEInterface() for _ in range(3)]
+    for ale in ales:
+        ale.setInt("random_seed", 123)
+        ale.loadROM(test_rom_path)
+
+    # An active player B draws its own sticky action numbers, so only the
+    # environments where it plays follow the same sequence. Tetris has a
+    # single player, so player B neither plays nor scores.
+    expected = [ales[1].act(int(a), 1) for a in actions]
+    assert all(r_b == 0 for _, r_b in expected)
+
+    rewards, _ = ales[2].actSequence(
+        actions, stop_on_terminal=False, actions_b=np.ones_like(actions)
+    )
+    assert rewards.shape == (len(actions), 2)
+    assert [tuple(r) for r in rewards] == expected
+    assert np.array_equal(ales[1].getRAM(), ales[2].getRAM())
+
+    ales[0].startTrajectory()
+    with pytest.raises(RuntimeError):
+        ales[0].act(0, 0)
+
+
+def test_act_sequence_stop_on_terminal(tetris):
+    rewards, terminal = tetris.actSequence(np.zeros(100000, dtype=np.int32))
+    assert tetris.game_over()
+    assert terminal < len(rewards)
+    assert not rewards[terminal + 1 :].any()
+
+
+def test_act_continuous_needs_paddles(tetris):
+    # Tetris is played with a joystick
+    with pytest.raises(RuntimeError):
+        tetris.actContinuous(0.5)
+    with pytest.raises(RuntimeError):
+        tetris.actContinuousSequence(np.linspace(0, 1, 10), fire=np.ones(10, bool))
+
+
+def test_trajectory_replay(test_rom_path, tmp_path):
+    trajectories = []
+    expected = []
+    for seed in range(3):
+        ale = ale_py.ALEInterface()
+        ale.setInt("random_seed", seed)
+        ale.loadROM(test_rom_path)
+        for _ in range(seed * 10):
+            ale.act(1)
+
+        state = ale.cloneState()
+        ale.startTrajectory()
+        # Changes the trajectory couldn't replay are refused
+        with pytest.raises(RuntimeError):
+            ale.restoreState(state)
+        with pytest.raises(RuntimeError):
+            ale.setRAM(0, 0)
+        with pytest.raises(RuntimeError):
+            ale.setMode(ale.getAvailableModes()[0])
+        screens = []
+        for a in np.random.randint(0, 5, size=300):
+            ale.act(int(a))
+            screens.append(ale.getScreenRGB())
+        path = tmp_path / f"{seed}.alet"
+        ale.stopTrajectory().save(path)
+        assert not ale.isLoggingTrajectory()
+
+        trajectories.append(ale_py.Trajectory.load(path))
+        expected.append(np.stack(screens))
+
+    replays = ale_py.ALEInterface.replayTrajectories(trajectories, test_rom_path, threads=2)
+    for (observations, rewards), screens in zip(replays, expected):
+        assert rewards.shape == (300,)
+        assert np.array_equal(observations, screens)
+
+
+def test_get_audio_frame(tetris, test_rom_path, tmp_path):
+    tetris.act(0)
+    assert tetris.getAudioFrame().shape == (0,)
+
+    ale = ale_py.ALEInterface()
+    ale.setBool("sound_obs", True)
+    ale.setString("record_sound_filename", str(tmp_path / "sound.wav"))
+    ale.loadROM(test_rom_path)
+    for _ in range(10):
+        ale.act(0)
+    samples = ale.getAudioFrame()
+    assert samples.shape == (512,)
+    assert samples.dtype == np.uint8
+
+    del ale
+    with wave.open(str(tmp_path / "sound.wav")) as f:
+        assert f.getnchannels() == 1
+        assert f.getsampwidth() == 1
+        assert f.getnframes() % 512 == 0
+        assert f.getnframes() >= 10 * 512
+
+
 def test_game_over(tetris):
     assert not tetris.game_over()
     while not tetris.game_over():
@@ -93,6 +230,51 @@ def test_reset_game(tetris):
     assert (tetris.getRAM() == ram).all()
 
 
+def test_noop_starts(test_rom_path):
+    ales = [ale_py.ALEInterface() for _ in range(2)]
+    for ale, cache in zip(ales, [False, True]):
+        ale.setInt("random_seed", 7)
+        ale.setInt("noop_max", 30)
+        ale.setBool("cache_resets", cache)
+        ale.loadROM(test_rom_path)
+
+    noops = set()
+    for _ in range(50):
+        for ale in ales:
+            ale.reset_game()
+        noops.add(ales[0].getEpisodeFrameNumber())
+        assert ales[1].getEpisodeFrameNumber() == ales[0].getEpisodeFrameNumber()
+        assert ales[1].getFrameNumber() == ales[0].getFrameNumber()
+        assert np.array_equal(ales[1].getScreen(), ales[0].getScreen())
+        for ale in ales:
+            ale.act(0)
+    assert noops <= set(range(1, 31)) and len(noops) > 10
+
+    start = ales[0].cloneState()
+    ales[0].setStartStates([start])
+    ales[0].reset_game()
+    with pytest.raises(RuntimeError):
+        ales[0].startTrajectory()
+    ales[0].setStartStates([])
+    ales[0].startTrajectory()
+
+
+def test_ram_only(test_rom_path):
+    ales = [ale_py.ALEInterface() for _ in range(2)]
+    for ale, ram_only in zip(ales, [False, True]):
+        ale.setInt("random_seed", 7)
+        ale.setBool("ram_only", ram_only)
+        ale.loadROM(test_rom_path)
+    assert ales[1].getScreen().size == 0
+
+    actions = ales[0].getMinimalActionSet()
+    for i in range(500):
+        action = actions[i % len(actions)]
+        assert ales[1].act(action) == ales[0].act(action)
+        assert ales[1].game_over() == ales[0].game_over()
+        assert np.array_equal(ales[1].getRAM(), ales[0].getRAM())
+
+
 def test_get_legal_action_set(tetris):
     action_set = tetris.getLegalActionSet()
     assert len(action_set) == 18
@@ -209,6 +391,20 @@ def test_is_rom_supported(ale, test_rom_path, random_rom_path):
         ale.isSupportedROM("notfound")
 
 
+def test_scan_roms(ale, test_rom_path, random_rom_path):
+    roms = ale.scanROMs([test_rom_path, random_rom_path, "notfound"], threads=2)
+    assert len(roms) == 3
+    assert roms[pathlib.Path(test_rom_path)] == "tetris"
+    assert roms[pathlib.Path(random_rom_path)] is None
+    assert roms[pathlib.Path("notfound")] is None
+
+    roms = ale.scanROMDirectory(os.path.dirname(test_rom_path))
+    assert roms[pathlib.Path(test_rom_path)] == "tetris"
+    assert roms[pathlib.Path(random_rom_path)] is None
+    with pytest.raises(RuntimeError):
+        ale.scanROMDirectory("notfound")
+
+
 def test_clone_restore_state(tetris):
     state = tetris.cloneState()
 
@@ -318,6 +514,29 @@ def test_clone_restore_state_include_rng(ale, test_rom_path):
     assert not _all_equal(second_half, second_half_without_rng)
 
 
+@pytest.mark.parametrize("rng", ["mt19937", "xoshiro128++"])
+def test_rng_generators(ale, test_rom_path, rng):
+    ale.setInt("random_seed", 0)
+    ale.setString("rng", rng)
+    ale.loadROM(test_rom_path)
+
+    def _run():
+        rams = []
+        for i in range(100):
+            ale.act(i % 5)
+            rams.append(ale.getRAM().tobytes())
+        return rams
+
+    state = ale.cloneState(include_rng=True)
+    first = _run()
+    ale.restoreState(state)
+    assert _run() == first
+
+    # Two 2.5KB Mersenne Twister states versus two 16 byte ones
+    size = len(ale.cloneSystemState().serialize())
+    assert size > 5000 if rng == "mt19937" else size < 2000
+
+
 def test_clone_restore_system_state(ale, test_rom_path):
     ale.setInt("random_seed", 0)
     ale.setFloat("repeat_action_probability", 0.25)
@@ -387,3 +606,181 @@ def test_set_logger(ale):
     ale.setLoggerMode(ale_py.LoggerMode.Info)
     ale.setLoggerMode(ale_py.LoggerMode.Warning)
     ale.setLoggerMode(ale_py.LoggerMode.Error)
+
+
+def test_logger_json_lines(tmp_path, test_rom_path):
+    path = tmp_path / "ale.log"
+    ale_py.ALEInterface.setLoggerMode(ale_py.LoggerMode.Info)
+    ale_py.ALEInterface.setLoggerFormat(ale_py.LoggerFormat.JSONLines)
+    ale_py.ALEInterface.setLoggerFile(str(path))
+    try:
+        ale = ale_py.ALEInterface()
+        ale.setInt("random_seed", 123)
+        ale.loadROM(test_rom_path)
+    finally:
+        ale_py.ALEInterface.setLoggerFile("")
+        ale_py.ALEInterface.setLoggerFormat(ale_py.LoggerFormat.Text)
+        ale_py.ALEInterface.setLoggerMode(ale_py.LoggerMode.Error)
+
+    records = [json.loads(line) for line in path.read_text().splitlines()]
+    assert {"time", "level", "thread", "message"} <= set(records[0])
+    assert {"level": "info", "message": "Random seed is 123"}.items() <= next(
+        r for r in records if "Random seed" in r["message"]
+    ).items()
+
+    with pytest.raises(RuntimeError):
+        ale_py.ALEInterface.setLoggerFile(str(tmp_path / "missing" / "ale.log"))
+
+def test_memory_footprint(ale, test_rom_path):
+    footprint = ale.memoryFootprint()
+    assert "settings" in footprint and "tia" not in footprint
+
+    ale.loadROM(test_rom_path)
+    footprint = ale.memoryFootprint()
+    for key in ["settings", "properties", "system", "tia", "screen", "total"]:
+        assert footprint[key] > 0
+    assert footprint["phosphor_blend"] == 0 and footprint["shared"] == 0
+    assert footprint["total"] == sum(
+        v for k, v in footprint.items() if k not in ("total", "shared")
+    )
+
+    ale.setBool("color_averaging", True)
+    ale.loadROM(test_rom_path)
+    assert ale.memoryFootprint()["shared"] > 0
+
+
+def test_profile_rom(test_rom_path):
+    profile = ale_py.ALEInterface.profileROM(test_rom_path, frames=200)
+    assert profile["frames"] >= 200
+    assert profile["ns_per_frame"] > 0
+    if ale_py._ale_py.PERF_COUNTERS:
+        assert profile["cpu_instructions_per_frame"] > 0
+        assert profile["tia_clocks_per_frame"] > 0
+        assert 0 < profile["device_access_ratio"] < 1
+    else:
+        assert "cpu_instructions_per_frame" not in profile
+
+
+def test_rollout_engine(tetris, test_rom_path):
+    tetris.setFloat("repeat_action_probability", 0.0)
+    tetris.loadROM(test_rom_path)
+    actions = tetris.getMinimalActionSet()
+    root = tetris.cloneState()
+
+    engine = ale_py.RolloutEngine(tetris, threads=2)
+    returns, terminals, lengths, states = engine.run(
+        root, 6, 20, actions, return_states=True, seed=3
+    )
+    assert returns.shape == (6,)
+    assert terminals.dtype == np.bool_
+    assert np.all(lengths == 20)
+    assert len(states) == 6
+
+    # Results don't depend on the number of threads
+    serial = ale_py.RolloutEngine(tetris, threads=1)
+    _, _, _, serial_states = serial.run(root, 6, 20, actions, return_states=True, seed=3)
+    assert all(a.equals(b) for a, b in zip(states, serial_states))
+    assert engine.run(root, 6, 20, actions)[3] is None
+
+    # Always choosing the same action matches playing it
+    probabilities = [1.0] + [0.0] * (len(actions) - 1)
+    _, _, _, states = engine.run(root, 1, 10, actions, probabilities, True)
+    for _ in range(10):
+        tetris.act(actions[0])
+    assert states[0].equals(tetris.cloneState())
+
+    steps = []
+
+    def policy(rollout, step, ram):
+        assert ram.shape == (128,)
+        steps.append((rollout, step))
+        return actions[0]
+
+    _, _, lengths, states = engine.run(root, 2, 10, policy, return_states=True)
+    assert np.all(lengths == 10)
+    assert sorted(steps) == [(r, s) for r in range(2) for s in range(10)]
+    assert states[1].equals(tetris.cloneState())
+
+    with pytest.raises(RuntimeError):
+        engine.run(root, 1, 10, actions, [1.0])
+
+
+def test_rollout_engine_expand(tetris, test_rom_path):
+    tetris.setFloat("repeat_action_probability", 0.0)
+    tetris.loadROM(test_rom_path)
+    actions = tetris.getMinimalActionSet()
+
+    frontier = []
+    for action in actions[:3]:
+        tetris.act(action)
+        frontier.append(tetris.cloneState())
+
+    engine = ale_py.RolloutEngine(tetris, threads=2)
+    children, rewards, terminals = engine.expand(frontier, actions)
+    assert len(children) == len(frontier) * len(actions)
+    assert rewards.shape == terminals.shape == (len(frontier), len(actions))
+
+    for s, state in enumerate(frontier):
+        for a, action in enumerate(actions):
+            tetris.restoreState(state)
+            assert rewards[s, a] == tetris.act(action)
+            assert terminals[s, a] == tetris.game_over()
+            assert children[s * len(actions) + a].equals(tetris.cloneState())
+
+
+def test_perf_stats(tetris):
+    if not ale_py._ale_py.PERF_COUNTERS:
+        assert tetris.getPerfStats() == {}
+        return
+
+    for _ in range(10):
+        tetris.act(0)
+    stats = tetris.getPerfStats()
+    for key in ["cpu_instructions", "tia_clocks", "direct_peeks", "rom_step_calls"]:
+        assert stats[key] > 0
+    assert stats["process_screen_calls"] == stats["process_ram_calls"]
+
+    tetris.resetPerfStats()
+    assert not any(tetris.getPerfStats().values())
+
+
+def test_trace(tetris, tmp_path):
+    ale_py.ALEInterface.enableTracing()
+    try:
+        for _ in range(10):
+            tetris.act(0)
+        tetris.reset_game()
+    finally:
+        ale_py.ALEInterface.disableTracing()
+
+    path = tmp_path / "trace.json"
+    ale_py.ALEInterface.dumpTrace(path, clear=True)
+    with open(path) as f:
+        events = json.load(f)["traceEvents"]
+    names = {event["name"] for event in events if event["ph"] == "X"}
+    assert {"act", "emulate", "reset", "softReset"} <= names
+
+    ale_py.ALEInterface.dumpTrace(path)
+    with open(path) as f:
+        assert all(event["ph"] == "M" for event in json.load(f)["traceEvents"])
+
+
+def test_record_screen_file(test_rom_path, tmp_path):
+    from ale_py.scripts.convert_recording import read_recording
+
+    path = tmp_path / "frames.alev"
+    ale = ale_py.ALEInterface()
+    ale.setString("record_screen_file", str(path))
+    ale.loadROM(test_rom_path)
+
+    # Each act() records the screen as it was before the step
+    screens = []
+    for _ in range(100):
+        screens.append(ale.getScreenRGB())
+        ale.act(0)
+    del ale
+
+    frames = list(read_recording(path))
+    assert len(frames) == len(screens)
+    for frame, screen in zip(frames, screens):
+        assert np.array_equal(frame, screen)